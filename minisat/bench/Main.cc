@@ -0,0 +1,318 @@
+/*****************************************************************************************[Main.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <zlib.h>
+#include "minisat/utils/System.h"
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/utils/Options.h"
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Propagation traces:
+//
+// A trace is a sequence of decisions and backtracks, stored one step per line:
+//
+//   d <lit>     -- open a new decision level, assign the (DIMACS) literal and propagate.
+//   b <level>   -- backtrack to the given decision level.
+//
+// Lines starting with 'c' are comments. Since unit propagation reaches the same fixpoint (or a
+// conflict) whatever order it visits the watchers in, replaying a trace against the same CNF
+// reproduces the assignments of the run that recorded it.
+
+
+struct Step {
+    int kind;   // 'd' or 'b'.
+    int arg;    // Decided literal as 'toInt(Lit)', or level to backtrack to.
+    Step(int k, int a) : kind(k), arg(a) {}
+};
+
+
+// Exposes the search primitives of 'Solver' to the benchmarks.
+class BenchSolver : public Solver {
+    vec<Lit> learnt;
+
+public:
+    // Conflict analysis: analyzed conflicts, literals of the resulting clauses and time spent.
+    uint64_t analyzed, analyzed_lits;
+    double   analyze_time;
+
+    // (strengthening antecedents would change the original clauses the trace was recorded against)
+    BenchSolver() : analyzed(0), analyzed_lits(0), analyze_time(0) { use_otfs = false; }
+
+    void record     (vec<Step>& trace, int max_decisions);
+    bool replay     (const vec<Step>& trace, bool analyze_confls = false);
+    void fillLearnts(int n);
+    void reduce     () { reduceDB(); }
+    int  nLocal     () const { return local_learnts; }
+};
+
+
+// Walks the search space with random decisions and random non-chronological backtracks, so that
+// the trace exercises propagation the way a CDCL search does, but without learning: replaying it
+// needs nothing but the original clauses. After a conflict at level 'd' the walk backtracks to a
+// random level in [d/2, d-1]; after a full assignment it restarts from level 0.
+void BenchSolver::record(vec<Step>& trace, int max_decisions)
+{
+    int decs = 0;
+    while (decs < max_decisions){
+        if (propagate() != CRef_Undef){
+            if (decisionLevel() == 0) break;
+            int lvl = decisionLevel() / 2 + irand(random_seed, decisionLevel() - decisionLevel() / 2);
+            cancelUntil(lvl);
+            trace.push(Step('b', lvl));
+            continue; }
+
+        // Pick an unassigned decision variable, scanning from a random position:
+        Var next = var_Undef;
+        Var start = irand(random_seed, nVars());
+        for (int i = 0; i < nVars() && next == var_Undef; i++){
+            Var v = (start + i) % nVars();
+            if (value(v) == l_Undef && varprefs[v].decision)
+                next = v; }
+
+        if (next == var_Undef){
+            if (decisionLevel() == 0) break;
+            cancelUntil(0);
+            trace.push(Step('b', 0));
+            continue; }
+
+        Lit p = mkLit(next, drand(random_seed) < 0.5);
+        newDecisionLevel();
+        uncheckedEnqueue(p);
+        trace.push(Step('d', toInt(p)));
+        decs++;
+    }
+    cancelUntil(0);
+}
+
+
+// Returns false if the trace does not fit the loaded CNF. With 'analyze_confls', conflicts are
+// analyzed as in 'search()', but the learnt clauses are thrown away.
+bool BenchSolver::replay(const vec<Step>& trace, bool analyze_confls)
+{
+    for (int i = 0; i < trace.size(); i++)
+        if (trace[i].kind == 'd'){
+            Lit p = toLit(trace[i].arg);
+            if (var(p) >= nVars() || value(p) != l_Undef) return false;
+            newDecisionLevel();
+            uncheckedEnqueue(p);
+            CRef confl = propagate();
+            if (confl != CRef_Undef && analyze_confls){
+                int    backtrack_level, lbd;
+                double started = cpuTime();
+                learnt.clear();
+                analyze(confl, learnt, backtrack_level, lbd);
+                analyze_time  += cpuTime() - started;
+                analyzed      ++;
+                analyzed_lits += learnt.size(); }
+        }else{
+            if (trace[i].arg > decisionLevel()) return false;
+            cancelUntil(trace[i].arg); }
+    cancelUntil(0);
+    return true;
+}
+
+
+//=================================================================================================
+// Learnt clause database reduction:
+//
+// 'reduceDB()' only looks at the clause headers, so it can be timed on synthetic learnt clauses: random
+// literals with random LBDs and activities. They are attached like real ones, but never propagated.
+
+
+// Adds local-tier learnt clauses of 3 to 32 random literals until there are 'n'.
+void BenchSolver::fillLearnts(int n)
+{
+    vec<Lit> lits;
+    int      max_size = nVars() < 32 ? nVars() : 32;
+    while (local_learnts < n){
+        lits.clear();
+        int size = 3 + irand(random_seed, max_size - 2);
+        for (int i = 0; i < size; i++){
+            Var v = irand(random_seed, nVars());
+            if (seen[v]) continue;
+            seen[v] = 1;
+            lits.push(mkLit(v, drand(random_seed) < 0.5)); }
+        for (int i = 0; i < lits.size(); i++)
+            seen[var(lits[i])] = 0;
+        if (lits.size() < 3) continue;
+
+        CRef cr = ca.alloc(lits, true);
+        ca[cr].lbd(2 + irand(random_seed, lits.size() - 1));
+        ca[cr].activity() = (float)(drand(random_seed) * cla_inc);
+        setTier(ca[cr], tier_local);
+        learnts.push(cr);
+        attachClause(cr);
+    }
+}
+
+
+//=================================================================================================
+// Trace files:
+
+
+static void writeTrace(FILE* out, const vec<Step>& trace)
+{
+    fprintf(out, "c propagation trace: %d steps\n", trace.size());
+    for (int i = 0; i < trace.size(); i++)
+        if (trace[i].kind == 'd'){
+            Lit p = toLit(trace[i].arg);
+            fprintf(out, "d %s%d\n", sign(p) ? "-" : "", var(p)+1);
+        }else
+            fprintf(out, "b %d\n", trace[i].arg);
+}
+
+
+static void readTrace(gzFile input_stream, vec<Step>& trace)
+{
+    StreamBuffer in(input_stream);
+    for (;;){
+        skipWhitespace(in);
+        if (*in == EOF) break;
+        else if (*in == 'c')
+            skipLine(in);
+        else if (*in == 'd'){
+            ++in;
+            int lit = parseInt(in);
+            if (lit == 0) printf("PARSE ERROR! Bad decision in trace\n"), exit(3);
+            trace.push(Step('d', toInt(lit > 0 ? mkLit(lit-1) : ~mkLit(-lit-1))));
+        }else if (*in == 'b'){
+            ++in;
+            trace.push(Step('b', parseInt(in)));
+        }else
+            printf("PARSE ERROR! Unexpected char in trace: %c\n", *in), exit(3);
+    }
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options] <input-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+        setX86FPUPrecision();
+
+        // Extra options:
+        //
+        StringOption mode      ("BENCH", "mode",   "What to benchmark: 'prop' (replay a propagation trace), 'analyze' (also analyze its conflicts) or 'reduce' (learnt clause reduction).", "prop");
+        StringOption trace_file("BENCH", "trace",  "Trace file to replay (or to write, with -record).");
+        BoolOption   record    ("BENCH", "record", "Record a trace into the file given by -trace and exit.", false);
+        IntOption    decs      ("BENCH", "decs",   "Number of decisions in a recorded trace.", 100000, IntRange(1, INT32_MAX));
+        IntOption    reps      ("BENCH", "reps",   "Number of times the trace is replayed (or reductions per learnt count).", 5, IntRange(1, INT32_MAX));
+        IntOption    learnts   ("BENCH", "learnts","Largest number of learnt clauses to reduce (halved down to 1/8).", 1000000, IntRange(16, INT32_MAX));
+        BoolOption   gc        ("BENCH", "gc",     "Garbage collect the clause arena (see -gc-inplace, -gc-locality) before replaying.", false);
+
+        parseOptions(argc, argv, true);
+
+        if (argc < 2)
+            printf("ERROR! No input file. Use '--help' for help.\n"), exit(1);
+        if (record && trace_file == NULL)
+            printf("ERROR! -record needs a -trace file\n"), exit(1);
+        if (strcmp(mode, "prop") != 0 && strcmp(mode, "analyze") != 0 && strcmp(mode, "reduce") != 0)
+            printf("ERROR! Unknown benchmark mode: %s\n", (const char*)mode), exit(1);
+
+        BenchSolver S;
+        gzFile in = gzopen(argv[1], "rb");
+        if (in == NULL)
+            printf("ERROR! Could not open file: %s\n", argv[1]), exit(1);
+        parse_DIMACS(in, S);
+        gzclose(in);
+
+        printf("|  Number of variables:  %12d                                         |\n", S.nVars());
+        printf("|  Number of clauses:    %12d                                         |\n", S.nClauses());
+
+        if (!S.simplify())
+            printf("Solved by unit propagation, nothing to benchmark\n"), exit(0);
+
+        if (strcmp(mode, "reduce") == 0){
+            if (S.nVars() < 3)
+                printf("ERROR! Too few variables for learnt clauses\n"), exit(1);
+            for (int k = 3; k >= 0; k--){
+                int    n       = learnts >> k;
+                double elapsed = 0;
+                int    ranked  = 0;
+                for (int r = 0; r < reps; r++){
+                    S.fillLearnts(n);
+                    ranked += S.nLocal();
+                    double started = cpuTime();
+                    S.reduce();
+                    elapsed += cpuTime() - started;
+                }
+                printf("reduce %10d learnts : %8.3f ms   (%5.1f ns /clause)\n", n, elapsed * 1000 / reps, elapsed * 1e9 / ranked);
+            }
+            return 0;
+        }
+
+        vec<Step> trace;
+        if (record || trace_file == NULL){
+            S.record(trace, decs);
+            if (record){
+                FILE* out = fopen(trace_file, "wb");
+                if (out == NULL)
+                    printf("ERROR! Could not open file: %s\n", (const char*)trace_file), exit(1);
+                writeTrace(out, trace);
+                fclose(out);
+                printf("|  Recorded steps:       %12d                                         |\n", trace.size());
+                exit(0); }
+        }else{
+            gzFile tin = gzopen(trace_file, "rb");
+            if (tin == NULL)
+                printf("ERROR! Could not open file: %s\n", (const char*)trace_file), exit(1);
+            readTrace(tin, trace);
+            gzclose(tin);
+        }
+        printf("|  Trace steps:          %12d                                         |\n", trace.size());
+
+        if (gc) S.garbageCollect();
+
+        bool     analyze = strcmp(mode, "analyze") == 0;
+        uint64_t props   = S.propagations;
+        uint64_t visits  = S.watch_visits;
+        uint64_t derefs  = S.clause_visits;
+        double   started = cpuTime();
+        for (int r = 0; r < reps; r++)
+            if (!S.replay(trace, analyze))
+                printf("ERROR! Trace does not match the input file\n"), exit(1);
+        double   elapsed = cpuTime() - started;
+
+        props  = S.propagations  - props;
+        visits = S.watch_visits  - visits;
+        derefs = S.clause_visits - derefs;
+        printf("propagations          : %-12"PRIu64"   (%.0f /sec)\n", props, props / elapsed);
+        printf("watcher visits        : %-12"PRIu64"   (%4.2f /prop)\n", visits, (double)visits / props);
+        printf("clause derefs         : %-12"PRIu64"   (%4.2f /prop, %4.2f %% of visits)\n", derefs, (double)derefs / props, derefs * 100 / (double)visits);
+        if (analyze){
+            printf("analyzed conflicts    : %-12"PRIu64"   (%.0f /sec)\n", S.analyzed, S.analyzed / S.analyze_time);
+            printf("learnt literals       : %-12"PRIu64"   (%4.2f /conflict, %.0f ns /literal)\n", S.analyzed_lits, (double)S.analyzed_lits / S.analyzed, S.analyze_time * 1e9 / S.analyzed_lits);
+            printf("analysis time         : %g s\n", S.analyze_time); }
+        printf("CPU time              : %g s\n", elapsed);
+
+        return 0;
+    } catch (OutOfMemoryException&){
+        printf("===============================================================================\n");
+        printf("INDETERMINATE\n");
+        exit(0);
+    }
+}
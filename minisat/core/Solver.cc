@@ -39,12 +39,50 @@ static DoubleOption  opt_random_var_freq   (_cat, "rnd-freq",    "The frequency
 static DoubleOption  opt_random_seed       (_cat, "rnd-seed",    "Used by the random variable selection",         91648253, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls conflict clause minimization (0=none, 1=basic, 2=deep)", 2, IntRange(0, 2));
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
+static IntOption     opt_branch            (_cat, "branch",      "The branching heuristic (0=vsids, 1=vmtf, 2=lrb)", 0, IntRange(0, 2));
+static BoolOption    opt_shrink            (_cat, "shrink",      "Shrink the literals of each lower decision level in learnt clauses to a single UIP", true);
+static BoolOption    opt_binmin            (_cat, "bin-min",     "Minimize learnt clauses with the binary implications of the asserting literal", true);
+static BoolOption    opt_otfs              (_cat, "otfs",        "Strengthen antecedents subsumed by a resolvent during conflict analysis", true);
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
+static BoolOption    opt_lbd_restart       (_cat, "lbd-restart", "Restart when recent learnt clauses have a high LBD compared to the long-term average (overrides -luby)", false);
+static DoubleOption  opt_restart_margin    (_cat, "rmargin",     "Restart when the fast LBD average exceeds the slow one by this factor", 1.25, DoubleRange(1, true, HUGE_VAL, false));
+static BoolOption    opt_stable            (_cat, "stable",      "Alternate between focused and stable search modes", false);
+static IntOption     opt_mode_int          (_cat, "mode-int",    "Number of conflicts of the first focused and stable modes", 1000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_mode_inc          (_cat, "mode-inc",    "Mode length increase factor after each stable mode", 2, DoubleRange(1, true, HUGE_VAL, false));
+static DoubleOption  opt_focus_decay       (_cat, "focus-decay", "The variable activity decay factor in focused mode", 0.75, DoubleRange(0, false, 1, false));
+static IntOption     opt_stable_restart    (_cat, "stable-rfirst", "The base restart interval in stable mode", 1024, IntRange(1, INT32_MAX));
+static DoubleOption  opt_block_margin      (_cat, "bmargin",     "Block restarts when the trail exceeds its average size by this factor (0=never)", 1.4, DoubleRange(0, true, HUGE_VAL, false));
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_gc_inplace        (_cat, "gc-inplace",  "Compact the clause arena in place during garbage collection (no second arena)", true);
+static BoolOption    opt_gc_locality       (_cat, "gc-locality", "Copy the clauses watched by the most active variables first during garbage collection", false);
+static DoubleOption  opt_compact           (_cat, "compact",     "Renumber the variables densely once this fraction of them is fixed, substituted or eliminated (0=never)", 0, DoubleRange(0, true, 1, true));
 static IntOption     opt_min_learnts_lim   (_cat, "min-learnts", "Minimum learnt clause limit",  0, IntRange(0, INT32_MAX));
+static DoubleOption  opt_mem_soft          (_cat, "mem-soft",    "Shed learnt clauses when the memory reaches this fraction of the budget (set by -mem-lim)", 0.8, DoubleRange(0, false, 1, true));
+static IntOption     opt_inproc_int        (_cat, "inproc-int",  "Number of conflicts between two inprocessing passes", 5000, IntRange(1, INT32_MAX));
+static BoolOption    opt_probe             (_cat, "probe",       "Probe the roots of the binary implication graph for failed literals", true);
+static DoubleOption  opt_probe_eff         (_cat, "probe-eff",   "Probing tick budget as a fraction of the search propagations since the last pass", 0.05, DoubleRange(0, false, 1, true));
+static BoolOption    opt_els               (_cat, "els",         "Substitute equivalent literals found in the binary implication graph", true);
+static BoolOption    opt_subsume           (_cat, "subsume",     "Remove subsumed clauses and strengthen clauses between restarts", true);
+static DoubleOption  opt_subsume_eff       (_cat, "subsume-eff", "Subsumption tick budget (in literals) as a fraction of the search propagations since the last pass", 0.5, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_vivify            (_cat, "vivify",      "Vivify learnt clauses at level 0 between restarts", true);
+static DoubleOption  opt_vivify_eff        (_cat, "vivify-eff",  "Vivification tick budget as a fraction of the search propagations since the last pass", 0.1, DoubleRange(0, false, 1, true));
+static BoolOption    opt_lbd_reduce        (_cat, "lbd-reduce",  "Rank local-tier clauses by LBD before activity when reducing the database", false);
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Keep learnt clauses with at most this LBD forever", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Keep learnt clauses with at most this LBD while they take part in conflicts", 6, IntRange(0, INT32_MAX));
+static IntOption     opt_tier2_int         (_cat, "tier2-int",   "Number of conflicts a tier2 clause may go unused before it moves to the local tier", 10000, IntRange(1, INT32_MAX));
+static BoolOption    opt_hbr               (_cat, "hbr",         "Add hyper-binary resolvents found by propagation at decision level 1", false);
+
+
+const double Solver::lbd_ema_fast_alpha = 1.0 / 32;
+const double Solver::lbd_ema_slow_alpha = 1.0 / 16384;
+const double Solver::trail_ema_alpha    = 1.0 / 5000;
+const double Solver::lrb_step_init      = 0.4;
+const double Solver::lrb_step_min       = 0.06;
+const double Solver::lrb_step_dec       = 1e-6;
+const double Solver::lrb_decay          = 0.95;
 
 
 //=================================================================================================
@@ -61,12 +99,28 @@ Solver::Solver() :
   , random_var_freq  (opt_random_var_freq)
   , random_seed      (opt_random_seed)
   , luby_restart     (opt_luby_restart)
+  , lbd_restart      (opt_lbd_restart)
+  , restart_margin   (opt_restart_margin)
+  , use_stable       (opt_stable)
+  , mode_interval    (opt_mode_int)
+  , mode_inc         (opt_mode_inc)
+  , focus_decay      (opt_focus_decay)
+  , stable_restart_first (opt_stable_restart)
+  , block_margin     (opt_block_margin)
   , ccmin_mode       (opt_ccmin_mode)
+  , use_shrink       (opt_shrink)
+  , use_binmin       (opt_binmin)
+  , use_otfs         (opt_otfs)
   , phase_saving     (opt_phase_saving)
+  , branch_heur      (opt_branch)
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
+  , gc_inplace       (opt_gc_inplace)
+  , gc_locality      (opt_gc_locality)
+  , compact_frac     (opt_compact)
   , min_learnts_lim  (opt_min_learnts_lim)
+  , mem_soft         (opt_mem_soft)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -79,13 +133,49 @@ Solver::Solver() :
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
 
+    // Inprocessing and learnt clause tiers (user settable):
+    //
+  , inproc_interval  (opt_inproc_int)
+  , use_probe        (opt_probe)
+  , probe_effort     (opt_probe_eff)
+  , use_els          (opt_els)
+  , use_subsume      (opt_subsume)
+  , subsume_effort   (opt_subsume_eff)
+  , use_vivify       (opt_vivify)
+  , vivify_effort    (opt_vivify_eff)
+  , lbd_reduce       (opt_lbd_reduce)
+  , core_lbd         (opt_core_lbd)
+  , tier2_lbd        (opt_tier2_lbd)
+  , tier2_interval   (opt_tier2_int)
+  , use_hbr          (opt_hbr)
+
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , inproc_passes(0)
+  , probe_lits(0), probe_failed(0), els_vars(0), subsumed_clauses(0), subsume_strengthened(0)
+  , vivify_lits(0), vivify_clauses(0), elim_inproc_vars(0)
+  , probe_time(0), els_time(0), subsume_time(0), vivify_time(0), elim_inproc_time(0)
+  , watch_visits(0), clause_visits(0)
+  , hbr_bins(0), hbr_redundant(0)
+  , learnts_lbd(0), glue_learnts(0), lbd_updates(0)
+  , tier_promotions(0), tier2_demotions(0)
+  , reduces(0), reduce_learnts(0), reduce_time(0)
+  , blocked_restarts(0), mode_switches(0), stable_conflicts(0)
+  , shrunk_literals(0), binmin_literals(0), otfs_strengthened(0)
+  , gcs(0), learnt_gcs(0), gc_time(0)
+  , compactions(0), compacted_vars(0)
+  , mem_sheds(0)
 
   , watches            (WatcherDeleted(ca))
+  , watches_bin        (WatcherDeleted(ca))
   , order_heap         (VarOrderLt(activity))
+  , vmtf_first         (var_Undef)
+  , vmtf_last          (var_Undef)
+  , vmtf_search        (var_Undef)
+  , vmtf_stamps        (0)
+  , lrb_step           (lrb_step_init)
   , ok                 (true)
   , cla_inc            (1)
   , var_inc            (1)
@@ -95,13 +185,36 @@ Solver::Solver() :
   , progress_estimate  (0)
   , remove_satisfied   (true)
   , next_var           (0)
+  , next_inproc        (inproc_interval)
+  , inproc_props       (0)
+  , probe_head         (0)
+  , vivify_head        (0)
+  , lbd_stamp          (0)
+  , local_learnts      (0)
+  , next_tier2         (tier2_interval)
+  , lbd_ema_fast       (0)
+  , lbd_ema_slow       (0)
+  , trail_ema          (0)
+  , stable_mode        (false)
+  , mode_length        (mode_interval)
+  , next_mode_switch   (mode_interval)
+  , rephases           (0)
+  , target_assigned    (0)
+  , best_assigned      (0)
+  , mem_pressure       (false)
+  , mem_shed_limit     (0)
+  , next_mem_check     (0)
 
     // Resource constraints:
     //
   , conflict_budget    (-1)
   , propagation_budget (-1)
+  , mem_budget         (0)
   , asynch_interrupt   (false)
-{}
+{
+    for (int i = 0; i < mem_parts; i++)
+        mem_peak[i] = 0;
+}
 Solver::~Solver()
 {
 }
@@ -125,16 +238,40 @@ Var Solver::newVar(lbool upol, bool dvar)
 
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
-    assigns  .insert(v, l_Undef);
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
+    assigns  .init(v);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
+    equiv    .insert(v, lit_Undef);
+    hbr_data .insert(v, mkHbrData(lit_Undef, 0));
+    lrb_data .insert(v, mkLrbData(0, 0));
     activity .insert(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .insert(v, 0);
-    polarity .insert(v, true);
-    user_pol .insert(v, upol);
-    decision .reserve(v);
+    varprefs .reserve(v);    // (a reused variable keeps its 'decision' flag for 'setDecisionVar()')
+    varprefs[v].polarity   = true;
+    varprefs[v].best_pol   = true;
+    varprefs[v].target_val = l_Undef;
+    varprefs[v].user_pol   = upol;
+    if (!vmtf_links.has(v)){
+        // Append new variables to the VMTF queue (reused ones are already in it):
+        vmtf_links.insert(v, mkVmtfLink(vmtf_last, var_Undef));
+        vmtf_stamp.insert(v, 0);
+        if (vmtf_last == var_Undef) vmtf_first = v;
+        else vmtf_links[vmtf_last].next = v;
+        vmtf_last = v; }
+    vmtfMoveToFront(v);
     trail    .capacity(v+1);
     setDecisionVar(v, dvar);
-    return v;
+    if (ext_lits.size() == 0)
+        return v;
+
+    // After renumbering, the user gets a new variable (a reused one no longer stands for the
+    // variable it was released as):
+    if (ext_vars.has(v))
+        ext_lits[ext_vars[v]] = lit_Undef;
+    ext_vars.insert(v, ext_lits.size());
+    ext_lits.push(mkLit(v));
+    return ext_vars[v];
 }
 
 
@@ -142,9 +279,11 @@ Var Solver::newVar(lbool upol, bool dvar)
 // releases of the same variable).
 void Solver::releaseVar(Lit l)
 {
-    if (value(l) == l_Undef){
+    // (a substituted variable is in no clause, but its literals would be mapped by 'addClause()')
+    Var v = internVar(var(l));
+    if (v != var_Undef && value(v) == l_Undef && equiv[v] == lit_Undef){
         addClause(l);
-        released_vars.push(var(l));
+        released_vars.push(v);
     }
 }
 
@@ -154,6 +293,12 @@ bool Solver::addClause_(vec<Lit>& ps)
     assert(decisionLevel() == 0);
     if (!ok) return false;
 
+    // Substituted variables must not come back, and renumbered ones are given as the user knows them:
+    if (equiv_vars.size() > 0 || ext_lits.size() > 0)
+        for (int i = 0; i < ps.size(); i++){
+            ps[i] = intern(ps[i]);
+            assert(ps[i] != lit_Undef); }
+
     // Check if clause is satisfied and remove false/duplicate literals:
     sort(ps);
     Lit p; int i, j;
@@ -182,8 +327,9 @@ bool Solver::addClause_(vec<Lit>& ps)
 void Solver::attachClause(CRef cr){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    WatchLists& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if (c.learnt()) num_learnts++, learnts_literals += c.size();
     else            num_clauses++, clauses_literals += c.size();
 }
@@ -192,14 +338,15 @@ void Solver::attachClause(CRef cr){
 void Solver::detachClause(CRef cr, bool strict){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
+    WatchLists& ws = c.size() == 2 ? watches_bin : watches;
     
     // Strict or lazy detaching:
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) num_learnts--, learnts_literals -= c.size();
@@ -211,7 +358,10 @@ void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    if (locked(c)){
+        Lit implied = c.size() == 2 && value(c[0]) != l_True ? c[1] : c[0];
+        vardata[var(implied)].reason = CRef_Undef; }
+    if (c.learnt() && c.tier() == tier_local) local_learnts--;
     c.mark(1); 
     ca.free(cr);
 }
@@ -224,19 +374,24 @@ bool Solver::satisfied(const Clause& c) const {
     return false; }
 
 
-// Revert to the state at given level (keeping all assignment at 'level' but not beyond).
+// Revert to the state at given level (keeping all assignment at 'level' but not beyond). Inprocessing
+// clears 'heur': its assignments are no search, and should not leave their phases or learning rates.
 //
-void Solver::cancelUntil(int level) {
+void Solver::cancelUntil(int level, bool heur) {
     if (decisionLevel() > level){
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
-            assigns [x] = l_Undef;
-            if (phase_saving > 1 || (phase_saving == 1 && c > trail_lim.last()))
-                polarity[x] = sign(trail[c]);
+            assigns .unassign(x);
+            if (heur && (phase_saving > 1 || (phase_saving == 1 && c > trail_lim.last())))
+                varprefs[x].polarity = sign(trail[c]);
+            if (heur && branch_heur == branch_lrb) lrbUpdate(x);
             insertVarOrder(x); }
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        if (level == 0)
+            // Resolvents not added by 'search()' came from propagating several literals at level 1:
+            hbr_pending.clear();
     } }
 
 
@@ -244,33 +399,82 @@ void Solver::cancelUntil(int level) {
 // Major methods:
 
 
+void Solver::lrbDecay(Var v)
+{
+    LrbData& d = lrb_data[v];
+    if (d.unassigned != conflicts){
+        activity[v] *= pow(lrb_decay, (double)(conflicts - d.unassigned));
+        d.unassigned = conflicts;
+        if (order_heap.inHeap(v))
+            order_heap.increase(v); }
+}
+
+
 Lit Solver::pickBranchLit()
 {
     Var next = var_Undef;
 
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
+    if (branch_heur == branch_vmtf){
+        if (drand(random_seed) < random_var_freq && nVars() > 0){
+            next = irand(random_seed, nVars());
+            if (value(next) == l_Undef && varprefs[next].decision)
+                rnd_decisions++; }
+    }else if (drand(random_seed) < random_var_freq && !order_heap.empty()){
         next = order_heap[irand(random_seed,order_heap.size())];
-        if (value(next) == l_Undef && decision[next])
+        if (value(next) == l_Undef && varprefs[next].decision)
             rnd_decisions++; }
 
-    // Activity based decision:
-    while (next == var_Undef || value(next) != l_Undef || !decision[next])
+    // Most recently bumped unassigned variable:
+    if (branch_heur == branch_vmtf){
+        if (next == var_Undef || value(next) != l_Undef || !varprefs[next].decision){
+            while (vmtf_search != var_Undef && (value(vmtf_search) != l_Undef || !varprefs[vmtf_search].decision))
+                vmtf_search = vmtf_links[vmtf_search].prev;
+            next = vmtf_search; }
+    }else
+
+    // Activity based decision (with LRB, the activities of unassigned variables decay by 'lrb_decay'
+    // per conflict; this is applied lazily, until the top of the heap is up to date, and to each
+    // variable when it is assigned):
+    while (next == var_Undef || value(next) != l_Undef || !varprefs[next].decision)
         if (order_heap.empty()){
             next = var_Undef;
             break;
-        }else
+        }else if (branch_heur == branch_lrb && lrb_data[order_heap[0]].unassigned != conflicts)
+            lrbDecay(order_heap[0]);
+        else
             next = order_heap.removeMin();
 
     // Choose polarity based on different polarity modes (global or per-variable):
     if (next == var_Undef)
         return lit_Undef;
-    else if (user_pol[next] != l_Undef)
-        return mkLit(next, user_pol[next] == l_True);
+    else if (varprefs[next].user_pol != l_Undef)
+        return mkLit(next, varprefs[next].user_pol == l_True);
     else if (rnd_pol)
         return mkLit(next, drand(random_seed) < 0.5);
+    else if (stable_mode && varprefs[next].target_val != l_Undef)
+        return mkLit(next, varprefs[next].target_val == l_False);
     else
-        return mkLit(next, polarity[next]);
+        return mkLit(next, varprefs[next].polarity);
+}
+
+
+// Literal Block Distance: the number of distinct decision levels among the literals of 'c'.
+template<class V>
+int Solver::computeLBD(const V& c)
+{
+    if (lbd_levels.size() <= decisionLevel())
+        lbd_levels.growTo(decisionLevel() + 1, 0);
+
+    lbd_stamp++;
+    int lbd = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (lbd_levels[l] != lbd_stamp){
+            lbd_levels[l] = lbd_stamp;
+            lbd++; }
+    }
+    return lbd;
 }
 
 
@@ -291,7 +495,7 @@ Lit Solver::pickBranchLit()
 |        rest of literals. There may be others from the same level though.
 |  
 |________________________________________________________________________________________________@*/
-void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
+void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd)
 {
     int pathC = 0;
     Lit p     = lit_Undef;
@@ -303,16 +507,36 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
-        Clause& c = ca[confl];
+        Clause& c = p == lit_Undef ? ca[confl] : reasonClause(var(p));
 
-        if (c.learnt())
+        if (c.learnt()){
             claBumpActivity(c);
+            c.used(true);
+
+            // Clauses taking part in conflicts may have become glue-ier since they were learnt, and
+            // move up to the tier of their new LBD:
+            if (c.tier() != tier_core){
+                int lbd = computeLBD(c);
+                if (lbd < (int)c.lbd()){
+                    c.lbd(lbd);
+                    lbd_updates++;
+                    if (tierOf(lbd) < c.tier()){
+                        setTier(c, tierOf(lbd));
+                        tier_promotions++; }
+                }
+            }
+        }
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
 
             if (!seen[var(q)] && level(var(q)) > 0){
-                varBumpActivity(var(q));
+                if (branch_heur == branch_vmtf)
+                    vmtf_bumped.push(var(q));
+                else if (branch_heur == branch_lrb)
+                    lrb_data[var(q)].participated++;
+                else
+                    varBumpActivity(var(q));
                 seen[var(q)] = 1;
                 if (level(var(q)) >= decisionLevel())
                     pathC++;
@@ -320,6 +544,19 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
                     out_learnt.push(q);
             }
         }
+
+        // The resolvent contains the antecedent minus its implied literal (and literals false at level
+        // 0). If it has no other literals, it subsumes the antecedent, which can drop the implied
+        // literal. Original clauses are left alone while 'SimpSolver' tracks their occurrences:
+        int resolvent_size = pathC + out_learnt.size() - 1;
+        if (use_otfs && p != lit_Undef && resolvent_size >= 2 && resolvent_size < c.size() && (c.learnt() || remove_satisfied)){
+            int root_lits = 0;
+            for (int j = 1; j < c.size(); j++)
+                if (level(var(c[j])) == 0)
+                    root_lits++;
+            if (resolvent_size + root_lits == c.size() - 1)
+                otfStrengthen(reason(var(p)));
+        }
         
         // Select next clause to look at:
         while (!seen[var(trail[index--])]);
@@ -347,7 +584,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             if (reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = reasonClause(x);
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -359,6 +596,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 
     max_literals += out_learnt.size();
     out_learnt.shrink(i - j);
+    if (use_shrink) shrinkLearnt(out_learnt);
+    if (use_binmin) binaryMinimize(out_learnt);
     tot_literals += out_learnt.size();
 
     // Find correct backtrack level:
@@ -377,19 +616,35 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         out_learnt[1]     = p;
         out_btlevel       = level(var(p));
     }
+    out_lbd = computeLBD(out_learnt);
+
+    // Reason side rate: credit the variables that implied the literals of the learnt clause without
+    // taking part in the conflict themselves:
+    if (branch_heur == branch_lrb)
+        for (int i = 1; i < out_learnt.size(); i++){
+            if (reason(var(out_learnt[i])) == CRef_Undef) continue;
+            Clause& c = reasonClause(var(out_learnt[i]));
+            for (int k = 1; k < c.size(); k++){
+                Var x = var(c[k]);
+                if (!seen[x]){
+                    seen[x] = 1;
+                    lrb_data[x].reasoned++;
+                    analyze_toclear.push(c[k]); }
+            }
+        }
 
     for (int j = 0; j < analyze_toclear.size(); j++) seen[var(analyze_toclear[j])] = 0;    // ('seen[]' is now cleared)
+    if (branch_heur == branch_vmtf) vmtfBump();
 }
 
 
 // Check if 'p' can be removed from a conflict clause.
 bool Solver::litRedundant(Lit p)
 {
-    enum { seen_undef = 0, seen_source = 1, seen_removable = 2, seen_failed = 3 };
     assert(seen[var(p)] == seen_undef || seen[var(p)] == seen_source);
     assert(reason(var(p)) != CRef_Undef);
 
-    Clause*               c     = &ca[reason(var(p))];
+    Clause*               c     = &reasonClause(var(p));
     vec<ShrinkStackElem>& stack = analyze_stack;
     stack.clear();
 
@@ -418,7 +673,7 @@ bool Solver::litRedundant(Lit p)
             stack.push(ShrinkStackElem(i, p));
             i  = 0;
             p  = l;
-            c  = &ca[reason(var(p))];
+            c  = &reasonClause(var(p));
         }else{
             // Finished with current element 'p' and reason 'c':
             if (seen[var(p)] == seen_undef){
@@ -432,7 +687,7 @@ bool Solver::litRedundant(Lit p)
             // Continue with top element on stack:
             i  = stack.last().i;
             p  = stack.last().l;
-            c  = &ca[reason(var(p))];
+            c  = &reasonClause(var(p));
 
             stack.pop();
         }
@@ -442,6 +697,127 @@ bool Solver::litRedundant(Lit p)
 }
 
 
+// Replace each group of at least two literals at the same (lower) decision level by the negation of
+// the first UIP of that level, found by resolving only on literals of that level. This fails if a
+// reason brings in a literal of another level that is neither in the clause nor implied by it.
+void Solver::shrinkLearnt(vec<Lit>& out_learnt)
+{
+    if (out_learnt.size() <= 2) return;
+    sort(&out_learnt[1], out_learnt.size() - 1, LevelGt(vardata));
+
+    int i, j;
+    for (i = j = 1; i < out_learnt.size(); ){
+        int end = i + 1;
+        while (end < out_learnt.size() && level(var(out_learnt[end])) == level(var(out_learnt[i])))
+            end++;
+
+        Lit uip = end - i > 1 ? levelUIP(out_learnt, i, end) : lit_Undef;
+        if (uip != lit_Undef){
+            shrunk_literals += end - i - 1;
+            out_learnt[j++] = ~uip;
+            i = end;
+        }else
+            while (i < end) out_learnt[j++] = out_learnt[i++];
+    }
+    out_learnt.shrink(i - j);
+}
+
+
+// 'lits[from..to)' are all at the same decision level (below the current one). Returns the UIP, or
+// 'lit_Undef' on failure.
+Lit Solver::levelUIP(const vec<Lit>& lits, int from, int to)
+{
+    int lvl  = level(var(lits[from]));
+    int open = to - from;
+    shrink_marked.clear();
+    for (int i = from; i < to; i++){
+        seen[var(lits[i])] |= seen_mark;
+        shrink_marked.push(var(lits[i])); }
+
+    Lit uip = lit_Undef;
+    for (int t = trail_lim[lvl] - 1; ; t--){
+        Var x = var(trail[t]);
+        if (!(seen[x] & seen_mark)) continue;
+        if (--open == 0){
+            uip = trail[t];
+            break; }
+
+        assert(reason(x) != CRef_Undef);    // (only the first literal of a level is a decision)
+        Clause& c = reasonClause(x);
+        bool    ok = true;
+        for (int k = 1; k < c.size() && ok; k++){
+            Var y = var(c[k]);
+            if (level(y) == lvl){
+                if (!(seen[y] & seen_mark)){
+                    seen[y] |= seen_mark;
+                    shrink_marked.push(y);
+                    open++; }
+            }else if (level(y) != 0 && seen[y] != seen_source && seen[y] != seen_removable)
+                ok = false;
+        }
+        if (!ok) break;
+    }
+
+    for (int i = 0; i < shrink_marked.size(); i++)
+        seen[shrink_marked[i]] &= ~seen_mark;
+    return uip;
+}
+
+
+// A literal 'q' of the learnt clause is redundant if there is a binary clause containing
+// 'out_learnt[0]' and '~q'.
+void Solver::binaryMinimize(vec<Lit>& out_learnt)
+{
+    for (int i = 1; i < out_learnt.size(); i++)
+        seen[var(out_learnt[i])] |= seen_mark;
+
+    int              removed = 0;
+    const WatchList& wbin    = watches_bin.lookup(~out_learnt[0]);
+    for (int k = 0; k < wbin.size(); k++){
+        Lit imp = wbin[k].blocker;
+        if ((seen[var(imp)] & seen_mark) && value(imp) == l_True){
+            seen[var(imp)] &= ~seen_mark;
+            removed++; }
+    }
+
+    int i, j;
+    for (i = j = 1; i < out_learnt.size(); i++)
+        if (seen[var(out_learnt[i])] & seen_mark){
+            seen[var(out_learnt[i])] &= ~seen_mark;
+            out_learnt[j++] = out_learnt[i]; }
+    out_learnt.shrink(i - j);
+    binmin_literals += removed;
+}
+
+
+// Remove the implied literal (at index 0) and the literals false at level 0 from the antecedent 'cr'
+// of the current conflict. The literals of the current level are watched, so that the clause is not
+// falsified after backjumping (if only one is left, the clause is the learnt clause before
+// minimization and asserts it at the same level).
+void Solver::otfStrengthen(CRef cr)
+{
+    Clause& c = ca[cr];
+    detachClause(cr, true);
+
+    int i, j;
+    for (i = 1, j = 0; i < c.size(); i++)
+        if (level(var(c[i])) > 0)
+            c[j++] = c[i];
+    c.shrink(i - j);
+    retierShrunk(c);
+
+    for (int k = 0; k < 2; k++){
+        int max_i = k;
+        for (int i = k + 1; i < c.size(); i++)
+            if (level(var(c[i])) > level(var(c[max_i])))
+                max_i = i;
+        Lit tmp = c[k]; c[k] = c[max_i]; c[max_i] = tmp; }
+
+    attachClause(cr);
+    otfs_strengthened++;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyzeFinal : (p : Lit)  ->  [void]
@@ -468,7 +844,7 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
                 assert(level(x) > 0);
                 out_conflict.insert(~trail[i]);
             }else{
-                Clause& c = ca[reason(x)];
+                Clause& c = reasonClause(x);
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -484,8 +860,11 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
 void Solver::uncheckedEnqueue(Lit p, CRef from)
 {
     assert(value(p) == l_Undef);
-    assigns[var(p)] = lbool(!sign(p));
+    assigns.assign(p);
     vardata[var(p)] = mkVarData(from, decisionLevel());
+    if (branch_heur == branch_lrb){
+        lrbDecay(var(p));
+        lrb_data[var(p)] = mkLrbData(conflicts, conflicts); }
     trail.push_(p);
 }
 
@@ -504,23 +883,44 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 CRef Solver::propagate()
 {
     CRef    confl     = CRef_Undef;
+    bool    hbr       = use_hbr && decisionLevel() == 1;
     int     num_props = 0;
+    int     num_visits = 0;
+    int     num_derefs = 0;
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
-        vec<Watcher>&  ws  = watches.lookup(p);
+        WatchList&     ws  = watches.lookup(p);
         Watcher        *i, *j, *end;
         num_props++;
 
+        // Binary clauses first; the blocker is the other literal, so they are never inspected:
+        WatchList&     wbin = watches_bin.lookup(p);
+        for (int k = 0; k < wbin.size(); k++){
+            Lit imp = wbin[k].blocker;
+            num_visits++;
+            if (value(imp) == l_Undef){
+                uncheckedEnqueue(imp, wbin[k].cref);
+                if (hbr) hbr_data[var(imp)] = mkHbrData(p, hbrDepth(p) + 1);
+            }else if (value(imp) == l_False){
+                confl = wbin[k].cref;
+                break; }
+        }
+        if (confl != CRef_Undef){
+            qhead = trail.size();
+            break; }
+
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
+            num_visits++;
             if (value(blocker) == l_True){
                 *j++ = *i++; continue; }
 
             // Make sure the false literal is data[1]:
             CRef     cr        = i->cref;
             Clause&  c         = ca[cr];
+            num_derefs++;
             Lit      false_lit = ~p;
             if (c[0] == false_lit)
                 c[0] = c[1], c[1] = false_lit;
@@ -533,12 +933,19 @@ CRef Solver::propagate()
             if (first != blocker && value(first) == l_True){
                 *j++ = w; continue; }
 
-            // Look for new watch:
-            for (int k = 2; k < c.size(); k++)
-                if (value(c[k]) != l_False){
+            // Look for new watch. A true literal is at a level no higher than 'p' (the current one), so
+            // it stays true as long as 'false_lit' stays false, and the clause may keep watching
+            // 'false_lit' with that literal as blocker:
+            for (int k = 2; k < c.size(); k++){
+                lbool val = value(c[k]);
+                if (val == l_True){
+                    *j++ = Watcher(cr, c[k]);
+                    goto NextClause; }
+                else if (val == l_Undef){
                     c[1] = c[k]; c[k] = false_lit;
                     watches[~c[1]].push(w);
                     goto NextClause; }
+            }
 
             // Did not find watch -- clause is unit under assignment:
             *j++ = w;
@@ -548,15 +955,18 @@ CRef Solver::propagate()
                 // Copy the remaining watches:
                 while (i < end)
                     *j++ = *i++;
-            }else
+            }else{
                 uncheckedEnqueue(first, cr);
+                if (hbr) hyperBinary(first, c); }
 
         NextClause:;
         }
         ws.shrink(i - j);
     }
-    propagations += num_props;
-    simpDB_props -= num_props;
+    propagations  += num_props;
+    watch_visits  += num_visits;
+    clause_visits += num_derefs;
+    simpDB_props  -= num_props;
 
     return confl;
 }
@@ -567,32 +977,167 @@ CRef Solver::propagate()
 |  reduceDB : ()  ->  [void]
 |  
 |  Description:
-|    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
-|    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    Remove half of the learnt clauses of the local tier, minus the clauses locked by the current
+|    assignment. Locked clauses are clauses that are reason to some assignment. They are ranked by
+|    activity or, if 'lbd_reduce' is set, by LBD first. Core clauses (LBD <= 'core_lbd') are never
+|    removed, and tier2 clauses (LBD <= 'tier2_lbd') only after 'reduceTier2()' has moved them to the
+|    local tier for not taking part in any conflict for 'tier2_interval' conflicts.
 |________________________________________________________________________________________________@*/
-struct reduceDB_lt { 
-    ClauseAllocator& ca;
-    reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
-    bool operator () (CRef x, CRef y) { 
-        return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
-};
 void Solver::reduceDB()
 {
+    sampleMemory();
+
     int     i, j;
-    double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
+    double  start_time = cpuTime();
+    reduce_keys.clear();
+    for (i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.tier() == tier_local)
+            reduce_keys.push(mkReduceKey(c.size() == 2 ? 0 : lbd_reduce ? c.lbd() + 1 : 1, c.activity(), learnts[i]));
+    }
+    if (reduce_keys.size() == 0) return;
+
+    double  extra_lim = cla_inc / reduce_keys.size();     // Remove any clause below this activity
+    int     half      = reduce_keys.size() / 2;
 
-    sort(learnts, reduceDB_lt(ca));
+    // Only the split between the two halves matters, not the order within them:
+    select(reduce_keys, half, ReduceKeyLt());
     // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
     // and clauses with activity smaller than 'extra_lim':
-    for (i = j = 0; i < learnts.size(); i++){
-        Clause& c = ca[learnts[i]];
-        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
-            removeClause(learnts[i]);
-        else
-            learnts[j++] = learnts[i];
+    local_learnts = reduce_keys.size();
+    for (i = 0; i < reduce_keys.size(); i++){
+        Clause& c = ca[reduce_keys[i].cr];
+        if (c.size() > 2 && !locked(c) && (i < half || reduce_keys[i].act < extra_lim))
+            removeClause(reduce_keys[i].cr);
     }
+
+    for (i = j = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            learnts[j++] = learnts[i];
     learnts.shrink(i - j);
     checkGarbage();
+
+    reduces++;
+    reduce_learnts += reduce_keys.size();
+    reduce_time    += cpuTime() - start_time;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  checkMemory : ()  ->  [void]
+|  
+|  Description:
+|    Compare the memory of the solver to 'mem_soft' times 'mem_budget'. Past it, the local tier of
+|    learnt clauses is reduced early and its limit halved, and the arena is compacted in place, so
+|    that new learnt clauses reuse the freed space instead of growing it. From then on the limit
+|    stops growing and inprocessing is skipped. Clauses are only shed again when the memory has
+|    grown halfway to the budget since.
+|________________________________________________________________________________________________@*/
+void Solver::checkMemory()
+{
+    next_mem_check = conflicts + mem_check_interval;
+
+    MemUse   use[mem_parts];
+    uint64_t total = 0;
+    memory(use);
+    for (int i = 0; i < mem_parts; i++)
+        total += use[i].bytes;
+    if (total < (mem_pressure ? mem_shed_limit : mem_budget * mem_soft))
+        return;
+
+    mem_pressure = true;
+    mem_sheds++;
+    if (max_learnts > local_learnts)
+        max_learnts = local_learnts;
+    max_learnts /= 2;
+    if (max_learnts < min_learnts_lim)
+        max_learnts = min_learnts_lim;
+
+    reduceDB();
+    if (ca.wasted() > 0)
+        garbageCollect(ca.wasted(false) == 0);
+
+    // Shed again halfway from here to the budget:
+    memory(use);
+    total = 0;
+    for (int i = 0; i < mem_parts; i++)
+        total += use[i].bytes;
+    mem_shed_limit = total < mem_budget ? total + (mem_budget - total) / 2 : total;
+    if (verbosity >= 2)
+        printf("|  Memory budget:        %12"PRIu64" bytes, learnt limit %10d           |\n", total, (int)max_learnts);
+}
+
+
+void Solver::reduceTier2()
+{
+    for (int i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.tier() == tier_2){
+            if (c.used())
+                c.used(false);
+            else{
+                setTier(c, tier_local);
+                tier2_demotions++; }
+        }
+    }
+    next_tier2 = conflicts + tier2_interval;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  switchMode : [void]  ->  [void]
+|  
+|  Description:
+|    Alternate between the focused mode (frequent restarts, fast activity decay, saved phases) and
+|    the stable mode (rare restarts, 'var_decay', target phases). Each stable mode is followed by a
+|    focused mode 'mode_inc' times longer than the previous one. Phases are reset at every switch,
+|    alternately to the best phases seen and to the original or inverted phases.
+|________________________________________________________________________________________________@*/
+void Solver::switchMode()
+{
+    stable_mode = !stable_mode;
+    if (!stable_mode)
+        mode_length *= mode_inc;
+    next_mode_switch = conflicts + (uint64_t)mode_length;
+    mode_switches++;
+
+    switch (rephases++ % 4){
+    case 0: case 2:
+        if (best_assigned > 0)
+            for (Var v = 0; v < nVars(); v++)
+                varprefs[v].polarity = varprefs[v].best_pol;
+        break;
+    case 1:
+        for (Var v = 0; v < nVars(); v++)
+            varprefs[v].polarity = true;
+        break;
+    case 3:
+        for (Var v = 0; v < nVars(); v++)
+            varprefs[v].polarity = false;
+        break;
+    }
+
+    for (Var v = 0; v < nVars(); v++)
+        varprefs[v].target_val = l_Undef;
+    target_assigned = best_assigned = 0;
+}
+
+
+// The first 'n' literals of the trail are a conflict-free assignment. The longest one since the last
+// mode switch gives the best phases and, in stable mode, the target phases.
+void Solver::updatePhases(int n)
+{
+    if (stable_mode && n > target_assigned){
+        for (int i = 0; i < n; i++)
+            varprefs[var(trail[i])].target_val = lbool(!sign(trail[i]));
+        target_assigned = n; }
+
+    if (n > best_assigned){
+        for (int i = 0; i < n; i++)
+            varprefs[var(trail[i])].best_pol = sign(trail[i]);
+        best_assigned = n; }
 }
 
 
@@ -604,13 +1149,21 @@ void Solver::removeSatisfied(vec<CRef>& cs)
         if (satisfied(c))
             removeClause(cs[i]);
         else{
-            // Trim clause:
+            // Trim clause (one that becomes binary has to move to the binary watch lists):
             assert(value(c[0]) == l_Undef && value(c[1]) == l_Undef);
+            int trimmed_size = c.size();
+            for (int k = 2; k < c.size(); k++)
+                if (value(c[k]) == l_False)
+                    trimmed_size--;
+            bool rewatch = c.size() > 2 && trimmed_size == 2;
+            if (rewatch) detachClause(cs[i], true);
             for (int k = 2; k < c.size(); k++)
                 if (value(c[k]) == l_False){
                     c[k--] = c[c.size()-1];
                     c.pop();
                 }
+            retierShrunk(c);
+            if (rewatch) attachClause(cs[i]);
             cs[j++] = cs[i];
         }
     }
@@ -618,16 +1171,602 @@ void Solver::removeSatisfied(vec<CRef>& cs)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  inprocess : [void]  ->  [bool]
+|
+|  Description:
+|    Run the enabled inprocessing techniques: failed literal probing, equivalent literal
+|    substitution, subsumption, vivification and (with 'SimpSolver') variable elimination. Each
+|    technique gets a tick budget proportional to the search propagations since the previous pass,
+|    and keeps its own time and benefit statistics. Returns FALSE if the problem was found UNSAT.
+|
+|    Original clauses are only changed when 'remove_satisfied' is set, since 'SimpSolver' keeps
+|    occurrence lists of them otherwise.
+|
+|    Pre-conditions:
+|      * Current decision level must be 0.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    assert(decisionLevel() == 0);
+
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    uint64_t search_props = propagations - inproc_props;
+    inproc_passes++;
+
+    if (use_probe && !probe((uint64_t)(search_props * probe_effort)))
+        return false;
+    if (use_els && remove_satisfied && !substituteEquivs())
+        return false;
+    if (use_subsume && !subsume((uint64_t)(search_props * subsume_effort)))
+        return false;
+    if (use_vivify && !vivify((uint64_t)(search_props * vivify_effort)))
+        return false;
+
+    double start_time = cpuTime();
+    bool   res        = inprocessElim();
+    elim_inproc_time += cpuTime() - start_time;
+    if (!res || !compactVars()) return ok = false;
+
+    // The assumptions may have been substituted or renumbered:
+    for (int i = 0; i < assumptions.size(); i++)
+        assumptions[i] = intern(solve_assumps[i]);
+
+    next_inproc  = conflicts + inproc_interval;
+    inproc_props = propagations;
+    return true;
+}
+
+
+// The core solver keeps no occurrence lists, so it cannot eliminate variables:
+bool Solver::inprocessElim() { return true; }
+
+
+// Probe the literals that imply something through binary clauses, but are implied by none: they
+// imply the most. A literal whose propagation runs into a conflict is failed, and its negation is
+// a unit. With 'use_hbr', the probes also add hyper-binary resolvents.
+bool Solver::probe(uint64_t budget)
+{
+    assert(decisionLevel() == 0);
+
+    double   start_time  = cpuTime();
+    uint64_t start_props = propagations;
+
+    for (int n = 0; n < 2 * nVars() && propagations - start_props < budget; n++){
+        if (probe_head >= 2 * nVars())
+            probe_head = 0;
+        Lit p = toLit(probe_head++);
+        if (value(p) != l_Undef || !varprefs[var(p)].decision || watches_bin[p].size() == 0 || watches_bin[~p].size() > 0)
+            continue;
+
+        probe_lits++;
+        newDecisionLevel();
+        uncheckedEnqueue(p);
+        CRef confl = propagate();
+        if (confl == CRef_Undef && hbr_pending.size() > 0)
+            addHyperBinaries();
+        cancelUntil(0, false);
+
+        if (confl != CRef_Undef){
+            probe_failed++;
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef){
+                ok = false;
+                break; }
+        }
+    }
+
+    probe_time += cpuTime() - start_time;
+    return ok;
+}
+
+
+// Variables that are unassigned, decision variables and not assumptions (marked in 'seen'):
+bool Solver::elsNode(Lit p) const { return value(p) == l_Undef && varprefs[var(p)].decision && !seen[var(p)]; }
+
+
+// Find the strongly connected components of the binary implication graph (with an iterative
+// version of Tarjan's algorithm). All literals of a component are equivalent, and are replaced by
+// the one with the smallest variable. A component containing both 'x' and '~x' makes the problem
+// UNSAT.
+bool Solver::substituteEquivs()
+{
+    assert(decisionLevel() == 0);
+
+    double start_time = cpuTime();
+    int    found      = 0;
+    int    counter    = 0;
+
+    for (int i = 0; i < assumptions.size(); i++)
+        seen[var(assumptions[i])] = 1;
+
+    watches_bin.cleanAll();
+    els_index.clear(); els_index.growTo(2 * nVars(), 0);    // 0 = not visited yet, -1 = in a component.
+    els_low  .clear(); els_low  .growTo(2 * nVars(), 0);
+    els_stack.clear();
+
+    for (int r = 0; r < 2 * nVars() && ok; r++){
+        if (els_index[r] != 0 || !elsNode(toLit(r)))
+            continue;
+
+        els_index[r] = els_low[r] = ++counter;
+        els_stack .push(toLit(r));
+        els_frames.push(toLit(r));
+        els_edges .push(0);
+
+        while (els_frames.size() > 0 && ok){
+            Lit                 p  = els_frames.last();
+            const WatchList& ws = watches_bin[p];
+
+            if (els_edges.last() < ws.size()){
+                // Follow the next implication 'p -> q':
+                Lit q = ws[els_edges.last()++].blocker;
+                if (!elsNode(q))
+                    continue;
+                if (els_index[toInt(q)] == 0){
+                    els_index[toInt(q)] = els_low[toInt(q)] = ++counter;
+                    els_stack .push(q);
+                    els_frames.push(q);
+                    els_edges .push(0);
+                }else if (els_index[toInt(q)] > 0)
+                    els_low[toInt(p)] = std::min(els_low[toInt(p)], els_index[toInt(q)]);
+                continue;
+            }
+
+            // Done with 'p':
+            els_frames.pop();
+            els_edges .pop();
+            if (els_frames.size() > 0){
+                Lit parent = els_frames.last();
+                els_low[toInt(parent)] = std::min(els_low[toInt(parent)], els_low[toInt(p)]); }
+            if (els_low[toInt(p)] != els_index[toInt(p)])
+                continue;
+
+            els_comp.clear();
+            Lit rep = p;
+            Lit q;
+            do {
+                q = els_stack.last();
+                els_stack.pop();
+                els_index[toInt(q)] = -1;
+                els_comp.push(q);
+                if (var(q) < var(rep)) rep = q;
+            } while (q != p);
+
+            for (int i = 0; i < els_comp.size() && ok; i++)
+                if (seen[var(els_comp[i])])
+                    ok = false;
+                else
+                    seen[var(els_comp[i])] = 1;
+            for (int i = 0; i < els_comp.size(); i++)
+                seen[var(els_comp[i])] = 0;
+
+            // The component of the negated literals is found too; the first one decides:
+            for (int i = 0; i < els_comp.size() && ok; i++){
+                Var v = var(els_comp[i]);
+                if (v == var(rep) || equiv[v] != lit_Undef)
+                    continue;
+                equiv[v] = rep ^ sign(els_comp[i]);
+                equiv_vars.push(v);
+                setDecisionVar(v, false);
+                found++;
+            }
+        }
+    }
+    els_frames.clear();
+    els_edges .clear();
+
+    for (int i = 0; i < assumptions.size(); i++)
+        seen[var(assumptions[i])] = 0;
+
+    // Rewrite the clauses containing substituted variables:
+    if (found > 0 && ok){
+        els_vars += found;
+        for (int k = 0; k < 2; k++){
+            vec<CRef>& cs = k == 0 ? clauses : learnts;
+            for (int i = 0; i < cs.size() && ok; i++){
+                const Clause& c = ca[cs[i]];
+                if (c.mark() == 1) continue;
+
+                bool substituted = false;
+                for (int j = 0; j < c.size() && !substituted; j++)
+                    substituted = equiv[var(c[j])] != lit_Undef;
+                if (!substituted) continue;
+
+                inproc_tmp.clear();
+                for (int j = 0; j < c.size(); j++)
+                    inproc_tmp.push(equivLit(c[j]));
+                rewriteClause(cs[i], inproc_tmp);
+            }
+
+            int i, j;
+            for (i = j = 0; i < cs.size(); i++)
+                if (!isRemoved(cs[i]))
+                    cs[j++] = cs[i];
+            cs.shrink(i - j);
+        }
+        if (ok && propagate() != CRef_Undef)
+            ok = false;
+    }
+
+    els_time += cpuTime() - start_time;
+    return ok;
+}
+
+
+struct subsume_lt {
+    ClauseAllocator& ca;
+    subsume_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) { return ca[x].size() < ca[y].size(); }
+};
+
+// Check the clauses from the shortest to the longest against the ones checked before, which are
+// indexed under one of their literals: if all literals of a clause 'D' are in 'C', 'C' is removed;
+// if all but one, whose negation is in 'C', that negation can be removed from 'C'. An original
+// clause is not removed for a learnt one, which may be deleted later.
+bool Solver::subsume(uint64_t budget)
+{
+    assert(decisionLevel() == 0);
+
+    double   start_time = cpuTime();
+    uint64_t ticks      = 0;
+
+    subsume_cands.clear();
+    for (int i = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]) && !satisfied(ca[learnts[i]]))
+            subsume_cands.push(learnts[i]);
+    if (remove_satisfied)
+        for (int i = 0; i < clauses.size(); i++)
+            if (!isRemoved(clauses[i]) && !satisfied(ca[clauses[i]]))
+                subsume_cands.push(clauses[i]);
+    sort(subsume_cands, subsume_lt(ca));
+    subsume_occs.growTo(2 * nVars());
+
+    for (int i = 0; i < subsume_cands.size() && ticks < budget && ok; i++){
+        CRef    cr = subsume_cands[i];
+        Clause& c  = ca[cr];
+        for (int k = 0; k < c.size(); k++)
+            seen[var(c[k])] = sign(c[k]) ? 2 : 1;
+
+        Lit  strengthen = lit_Undef;
+        bool subsumed   = false;
+        for (int k = 0; k < 2 * c.size() && !subsumed && strengthen == lit_Undef; k++){
+            const vec<CRef>& occ = subsume_occs[toInt(c[k / 2]) ^ (k & 1)];
+            for (int m = 0; m < occ.size(); m++){
+                Clause& d = ca[occ[m]];
+                if (d.mark() == 1) continue;
+                ticks += d.size();
+
+                Lit  flip = lit_Undef;
+                bool sub  = true;
+                for (int l = 0; l < d.size() && sub; l++){
+                    char mark = seen[var(d[l])];
+                    if (mark == (sign(d[l]) ? 2 : 1))
+                        continue;
+                    else if (mark == 0 || flip != lit_Undef)
+                        sub = false;
+                    else
+                        flip = d[l];
+                }
+                if (!sub || (flip == lit_Undef && !c.learnt() && d.learnt()))
+                    continue;
+
+                if (flip != lit_Undef)
+                    strengthen = ~flip;
+                else{
+                    subsumed = true;
+                    if (c.learnt() && c.tier() < d.tier())
+                        setTier(d, c.tier());
+                }
+                break;
+            }
+        }
+        for (int k = 0; k < c.size(); k++)
+            seen[var(c[k])] = 0;
+
+        if (subsumed){
+            removeClause(cr);
+            subsumed_clauses++;
+            continue; }
+        if (strengthen != lit_Undef){
+            inproc_tmp.clear();
+            for (int k = 0; k < c.size(); k++)
+                if (c[k] != strengthen)
+                    inproc_tmp.push(c[k]);
+            subsume_strengthened++;
+            if (!rewriteClause(cr, inproc_tmp) || isRemoved(cr))
+                continue;
+        }
+
+        // Index the clause under its literal with the fewest clauses so far:
+        int best = 0;
+        for (int k = 1; k < c.size(); k++)
+            if (subsume_occs[toInt(c[k])].size() < subsume_occs[toInt(c[best])].size())
+                best = k;
+        subsume_occs[toInt(c[best])].push(cr);
+    }
+
+    for (int i = 0; i < subsume_occs.size(); i++)
+        subsume_occs[i].clear();
+    for (int k = 0; k < 2; k++){
+        vec<CRef>& cs = k == 0 ? clauses : learnts;
+        int i, j;
+        for (i = j = 0; i < cs.size(); i++)
+            if (!isRemoved(cs[i]))
+                cs[j++] = cs[i];
+        cs.shrink(i - j);
+    }
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+
+    subsume_time += cpuTime() - start_time;
+    return ok;
+}
+
+
+// Replace the literals of the clause 'cr' by 'lits', which must not be more. As in 'addClause_()',
+// a satisfied clause is removed and a unit is enqueued (the caller propagates). Returns FALSE if
+// 'lits' is falsified.
+bool Solver::rewriteClause(CRef cr, vec<Lit>& lits)
+{
+    assert(decisionLevel() == 0);
+
+    sort(lits);
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < lits.size(); i++)
+        if (value(lits[i]) == l_True || lits[i] == ~p){
+            removeClause(cr);
+            return true;
+        }else if (value(lits[i]) != l_False && lits[i] != p)
+            lits[j++] = p = lits[i];
+    lits.shrink(i - j);
+
+    if (lits.size() <= 1){
+        removeClause(cr);
+        if (lits.size() == 0)
+            return ok = false;
+        uncheckedEnqueue(lits[0]);
+        return true;
+    }
+
+    Clause& c = ca[cr];
+    assert(lits.size() <= c.size());
+    detachClause(cr, true);
+    for (int k = 0; k < lits.size(); k++)
+        c[k] = lits[k];
+    c.shrink(c.size() - lits.size());
+    retierShrunk(c);
+    attachClause(cr);
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  vivify : (budget : uint64_t)  ->  [bool]
+|
+|  Description:
+|    Try to shorten learnt clauses by assigning the negations of their literals one by one at a
+|    fresh decision level. A literal found to be false can be dropped, and the clause can be cut
+|    short as soon as a literal is implied true or propagation runs into a conflict. Each pass stops
+|    after 'budget' propagations, and resumes where the previous pass stopped.
+|
+|    Pre-conditions:
+|      * Current decision level must be 0.
+|________________________________________________________________________________________________@*/
+bool Solver::vivify(uint64_t budget)
+{
+    assert(decisionLevel() == 0);
+
+    double   start_time  = cpuTime();
+    uint64_t start_props = propagations;
+
+    if (vivify_head >= learnts.size())
+        vivify_head = 0;
+
+    for (int n = 0; n < learnts.size() && propagations - start_props < budget; n++){
+        CRef cr = learnts[vivify_head];
+        if (++vivify_head == learnts.size())
+            vivify_head = 0;
+
+        const Clause& c = ca[cr];
+        if (c.mark() == 0 && c.size() > 2 && !satisfied(c) && !vivifyClause(cr))
+            break;
+    }
+
+    // Forget clauses that were reduced to units:
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            learnts[j++] = learnts[i];
+    learnts.shrink(i - j);
+
+    vivify_time += cpuTime() - start_time;
+    return ok;
+}
+
+
+bool Solver::vivifyClause(CRef cr)
+{
+    Clause& c = ca[cr];
+
+    // Detach the clause so that it does not take part in its own propagation:
+    detachClause(cr, true);
+
+    newDecisionLevel();
+    vivify_tmp.clear();
+    for (int i = 0; i < c.size(); i++){
+        Lit l = c[i];
+        if (value(l) == l_True){
+            // Implied by the negation of the literals so far:
+            vivify_tmp.push(l);
+            break;
+        }else if (value(l) == l_False)
+            // Implied false by the negation of the literals so far:
+            continue;
+
+        vivify_tmp.push(l);
+        uncheckedEnqueue(~l);
+        if (propagate() != CRef_Undef)
+            // The negation of the literals so far is already conflicting:
+            break;
+    }
+    cancelUntil(0, false);
+
+    if (vivify_tmp.size() == c.size()){
+        attachClause(cr);
+        return true; }
+
+    vivify_lits += c.size() - vivify_tmp.size();
+    vivify_clauses++;
+
+    if (vivify_tmp.size() <= 1){
+        if (c.tier() == tier_local) local_learnts--;
+        c.mark(1);
+        ca.free(cr);
+        if (vivify_tmp.size() == 0)
+            return ok = false;
+        uncheckedEnqueue(vivify_tmp[0]);
+        return ok = (propagate() == CRef_Undef);
+    }
+
+    for (int i = 0; i < vivify_tmp.size(); i++)
+        c[i] = vivify_tmp[i];
+    c.shrink(c.size() - vivify_tmp.size());
+    retierShrunk(c);
+    attachClause(cr);
+
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  hyperBinary : (p : Lit) (c : const Clause&)  ->  [void]
+|  
+|  Description:
+|    Called when 'c' implies 'p' (at index 0) at decision level 1. Every level-1 literal has a
+|    dominator, a literal that implies it through binary clauses, so the literals of level 1 form a
+|    tree rooted at the decision. The deepest common dominator 'd' of the false literals of 'c' also
+|    implies 'p', and the hyper-binary resolvent '~d | p' is queued for 'addHyperBinaries()'; 'd'
+|    becomes the dominator of 'p'. Literals with no common dominator (several decisions at level 1,
+|    as in vivification) become roots of their own tree.
+|________________________________________________________________________________________________@*/
+void Solver::hyperBinary(Lit p, const Clause& c)
+{
+    Lit  dom   = lit_Undef;
+    bool found = true;
+    for (int k = 1; k < c.size() && found; k++)
+        if (level(var(c[k])) > 0){
+            Lit q = ~c[k];
+            if (dom == lit_Undef)
+                dom = q;
+            else if ((dom = hbrDominator(dom, q)) == lit_Undef)
+                found = false;
+        }
+
+    if (!found || dom == lit_Undef){
+        hbr_data[var(p)] = mkHbrData(lit_Undef, 0);
+        return; }
+
+    hbr_data[var(p)] = mkHbrData(dom, hbrDepth(dom) + 1);
+    if (c.size() > 2){
+        hbr_pending.push(~dom);
+        hbr_pending.push(p); }
+}
+
+
+Lit Solver::hbrDominator(Lit p, Lit q) const
+{
+    while (p != q){
+        int dp = hbrDepth(p), dq = hbrDepth(q);
+        if (dp == 0 && dq == 0) return lit_Undef;
+        if (dp >= dq) p = hbr_data[var(p)].dom;
+        if (dq >= dp) q = hbr_data[var(q)].dom;
+    }
+    return p;
+}
+
+
+// Called by 'search()' after each propagation, while both literals of the pending resolvents are
+// still true. A resolvent '~d | p' is transitively redundant if some level-1 literal
+// dominated by 'd' already implies 'p' through a binary clause.
+void Solver::addHyperBinaries()
+{
+    assert(decisionLevel() == 1);
+    for (int i = 0; i < hbr_pending.size(); i += 2){
+        Lit dom = ~hbr_pending[i];
+        Lit imp =  hbr_pending[i+1];
+        assert(value(dom) == l_True && value(imp) == l_True);
+
+        bool redundant = false;
+        const WatchList& ws = watches_bin[~imp];
+        for (int k = 0; k < ws.size() && !redundant; k++){
+            Lit q = ~ws[k].blocker;
+            redundant = ca[ws[k].cref].mark() == 0 && value(q) == l_True && level(var(q)) == 1
+                && (q == dom || hbrDominator(dom, q) == dom);
+        }
+        if (redundant){
+            hbr_redundant++;
+            continue; }
+
+        hbr_tmp.clear();
+        hbr_tmp.push(~dom);
+        hbr_tmp.push(imp);
+        CRef cr = ca.alloc(hbr_tmp, true);
+        learnts.push(cr);
+        attachClause(cr);
+        hbr_bins++;
+    }
+    hbr_pending.clear();
+}
+
+
 void Solver::rebuildOrderHeap()
 {
+    if (branch_heur == branch_vmtf){
+        vmtf_search = vmtf_last;
+        return; }
+
     vec<Var> vs;
     for (Var v = 0; v < nVars(); v++)
-        if (decision[v] && value(v) == l_Undef)
+        if (varprefs[v].decision && value(v) == l_Undef)
             vs.push(v);
     order_heap.build(vs);
 }
 
 
+void Solver::vmtfMoveToFront(Var v)
+{
+    if (v != vmtf_last){
+        VmtfLink& l = vmtf_links[v];
+        if (l.prev == var_Undef) vmtf_first = l.next;
+        else vmtf_links[l.prev].next = l.next;
+        vmtf_links[l.next].prev = l.prev;
+        l.prev = vmtf_last;
+        l.next = var_Undef;
+        vmtf_links[vmtf_last].next = v;
+        vmtf_last = v; }
+    vmtf_stamp[v] = ++vmtf_stamps;
+    if (value(v) == l_Undef && varprefs[v].decision)
+        vmtf_search = v;
+}
+
+
+// The variables are moved in the order they had in the queue, so that the ones bumped together
+// in a conflict keep their relative order:
+void Solver::vmtfBump()
+{
+    sort(vmtf_bumped, VmtfStampLt(vmtf_stamp));
+    for (int i = 0; i < vmtf_bumped.size(); i++)
+        vmtfMoveToFront(vmtf_bumped[i]);
+    vmtf_bumped.clear();
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  simplify : [void]  ->  [bool]
@@ -701,38 +1840,70 @@ lbool Solver::search(int nof_conflicts)
 {
     assert(ok);
     int         backtrack_level;
+    int         lbd;
     int         conflictC = 0;
+    int         lbd_restart_delay = restart_min_conflicts;
     vec<Lit>    learnt_clause;
     starts++;
 
     for (;;){
         CRef confl = propagate();
+        if (hbr_pending.size() > 0)
+            addHyperBinaries();
+
         if (confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++;
             if (decisionLevel() == 0) return l_False;
+            if (use_stable){
+                updatePhases(trail_lim.last());
+                if (stable_mode) stable_conflicts++; }
+
+            // Restarts are blocked while the trail is much larger than usual, since the search may
+            // be close to a model:
+            if (lbd_restart && !stable_mode){
+                if (block_margin > 0 && conflicts > restart_block_start && trail.size() > block_margin * trail_ema
+                    && lbd_restart_delay <= 0){
+                    lbd_restart_delay = restart_min_conflicts;
+                    blocked_restarts++; }
+                updateEMA(trail_ema, trail.size(), trail_ema_alpha);
+            }
 
             learnt_clause.clear();
-            analyze(confl, learnt_clause, backtrack_level);
+            analyze(confl, learnt_clause, backtrack_level, lbd);
             cancelUntil(backtrack_level);
 
+            learnts_lbd += lbd;
+            if (lbd <= 2) glue_learnts++;
+            if (lbd_restart && !stable_mode){
+                updateEMA(lbd_ema_fast, lbd, lbd_ema_fast_alpha);
+                updateEMA(lbd_ema_slow, lbd, lbd_ema_slow_alpha);
+                lbd_restart_delay--;
+            }
+
             if (learnt_clause.size() == 1){
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
+                ca[cr].lbd(lbd);
+                ca[cr].used(true);
+                setTier(ca[cr], tierOf(lbd));
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
                 uncheckedEnqueue(learnt_clause[0], cr);
+                if (use_hbr && decisionLevel() == 1)
+                    hyperBinary(learnt_clause[0], ca[cr]);
             }
 
-            varDecayActivity();
+            if (branch_heur == branch_vsids) varDecayActivity();
+            else if (branch_heur == branch_lrb && lrb_step > lrb_step_min) lrb_step -= lrb_step_dec;
             claDecayActivity();
 
             if (--learntsize_adjust_cnt == 0){
                 learntsize_adjust_confl *= learntsize_adjust_inc;
                 learntsize_adjust_cnt    = (int)learntsize_adjust_confl;
-                max_learnts             *= learntsize_inc;
+                if (!mem_pressure) max_learnts *= learntsize_inc;
 
                 if (verbosity >= 1)
                     printf("| %9d | %7d %8d %8d | %8d %8d %6.0f | %6.3f %% |\n", 
@@ -743,9 +1914,12 @@ lbool Solver::search(int nof_conflicts)
 
         }else{
             // NO CONFLICT
-            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()){
+            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()
+                || (lbd_restart && !stable_mode && lbd_restart_delay <= 0 && lbd_ema_fast > restart_margin * lbd_ema_slow)
+                || (use_stable && conflicts >= next_mode_switch)){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
+                if (use_stable) updatePhases(trail.size());
                 cancelUntil(0);
                 return l_Undef; }
 
@@ -753,7 +1927,17 @@ lbool Solver::search(int nof_conflicts)
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            // Inprocessing:
+            if (decisionLevel() == 0 && conflicts >= next_inproc && !mem_pressure && !inprocess())
+                return l_False;
+
+            if (conflicts >= next_tier2)
+                reduceTier2();
+
+            if (mem_budget > 0 && conflicts >= next_mem_check)
+                checkMemory();
+
+            if (local_learnts-nAssigns() >= max_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
 
@@ -842,6 +2026,12 @@ lbool Solver::solve_()
 
     solves++;
 
+    // Assumptions are made on the internal literals they stand for (the representatives of
+    // substituted variables, and renumbered variables):
+    assumptions.copyTo(solve_assumps);
+    for (int i = 0; i < assumptions.size(); i++)
+        assumptions[i] = intern(assumptions[i]);
+
     max_learnts = nClauses() * learntsize_factor;
     if (max_learnts < min_learnts_lim)
         max_learnts = min_learnts_lim;
@@ -858,12 +2048,20 @@ lbool Solver::solve_()
     }
 
     // Search:
-    int curr_restarts = 0;
+    int curr_restarts   = 0;
+    int stable_restarts = 0;
     while (status == l_Undef){
-        double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        if (stable_mode)
+            // Stable mode restarts rarely, whatever the focused restart policy:
+            status = search(luby(restart_inc, stable_restarts++) * stable_restart_first);
+        else{
+            double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
+            status = search(lbd_restart ? -1 : rest_base * restart_first);
+            curr_restarts++;
+        }
         if (!withinBudget()) break;
-        curr_restarts++;
+        if (use_stable && conflicts >= next_mode_switch)
+            switchMode();
     }
 
     if (verbosity >= 1)
@@ -874,10 +2072,35 @@ lbool Solver::solve_()
         // Extend & copy model:
         model.growTo(nVars());
         for (int i = 0; i < nVars(); i++) model[i] = value(i);
+        // Substituted variables follow their representatives (which may have been substituted later):
+        for (int i = equiv_vars.size()-1; i >= 0; i--)
+            model[equiv_vars[i]] = modelValue(equiv[equiv_vars[i]]);
+
+        if (ext_lits.size() > 0){
+            // In the numbering of the user (eliminated variables are left to 'SimpSolver'):
+            model.moveTo(solve_model);
+            model.growTo(ext_lits.size(), l_Undef);
+            for (int x = 0; x < ext_lits.size(); x++)
+                if (ext_lits[x] != lit_Undef)
+                    model[x] = solve_model[var(ext_lits[x])] ^ sign(ext_lits[x]);
+        }
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
+    if (assumptions.size() > 0){
+        // Express the final conflict in terms of the assumptions given:
+        solve_tmp.clear();
+        for (int i = 0; i < assumptions.size(); i++)
+            if (conflict.has(~assumptions[i]))
+                solve_tmp.push(~solve_assumps[i]);
+        conflict.clear();
+        for (int i = 0; i < solve_tmp.size(); i++)
+            conflict.insert(solve_tmp[i]);
+        solve_assumps.copyTo(assumptions);
+    }
+
     cancelUntil(0);
+    sampleMemory();
     return status;
 }
 
@@ -990,31 +2213,389 @@ void Solver::printStats() const
 {
     double cpu_time = cpuTime();
     double mem_used = memUsedPeak();
-    printf("restarts              : %"PRIu64"\n", starts);
+    if (use_stable)
+        printf("restarts              : %-12"PRIu64"   (%"PRIu64" mode switches, %4.2f %% stable conflicts)\n", starts, mode_switches, conflicts == 0 ? 0 : stable_conflicts*100 / (double)conflicts);
+    else if (lbd_restart)
+        printf("restarts              : %-12"PRIu64"   (%"PRIu64" blocked)\n", starts, blocked_restarts);
+    else
+        printf("restarts              : %"PRIu64"\n", starts);
     printf("conflicts             : %-12"PRIu64"   (%.0f /sec)\n", conflicts   , conflicts   /cpu_time);
     printf("decisions             : %-12"PRIu64"   (%4.2f %% random) (%.0f /sec)\n", decisions, (float)rnd_decisions*100 / (float)decisions, decisions   /cpu_time);
     printf("propagations          : %-12"PRIu64"   (%.0f /sec)\n", propagations, propagations/cpu_time);
     printf("conflict literals     : %-12"PRIu64"   (%4.2f %% deleted)\n", tot_literals, (max_literals - tot_literals)*100 / (double)max_literals);
+    printf("learnt LBD            : %-12.2f   (%"PRIu64" glue, %"PRIu64" lowered)\n", conflicts == 0 ? 0 : learnts_lbd / (double)conflicts, glue_learnts, lbd_updates);
+    int tiers[3] = { 0, 0, 0 };
+    for (int i = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            tiers[ca[learnts[i]].tier()]++;
+    printf("learnt tiers          : %d core, %d tier2, %d local   (%"PRIu64" promoted, %"PRIu64" demoted)\n", tiers[tier_core], tiers[tier_2], tiers[tier_local], tier_promotions, tier2_demotions);
+    printf("reductions            : %-12"PRIu64"   (%"PRIu64" clauses ranked, %g s)\n", reduces, reduce_learnts, reduce_time);
+    if (use_shrink || use_binmin)
+        printf("minimized literals    : %-12"PRIu64"   (%"PRIu64" shrunk, %"PRIu64" by binaries)\n", shrunk_literals + binmin_literals, shrunk_literals, binmin_literals);
+    if (use_otfs)
+        printf("otfs strengthened     : %"PRIu64"\n", otfs_strengthened);
+    if (use_hbr)
+        printf("hyper-binaries        : %-12"PRIu64"   (%"PRIu64" redundant)\n", hbr_bins, hbr_redundant);
+    printf("inprocessing passes   : %"PRIu64"\n", inproc_passes);
+    if (use_probe)
+        printf("failed literals       : %-12"PRIu64"   (%"PRIu64" probes, %g s)\n", probe_failed, probe_lits, probe_time);
+    if (use_els)
+        printf("equivalent variables  : %-12"PRIu64"   (%g s)\n", els_vars, els_time);
+    if (use_subsume)
+        printf("subsumed clauses      : %-12"PRIu64"   (%"PRIu64" strengthened, %g s)\n", subsumed_clauses, subsume_strengthened, subsume_time);
+    if (use_vivify)
+        printf("vivified literals     : %-12"PRIu64"   (%"PRIu64" clauses, %g s)\n", vivify_lits, vivify_clauses, vivify_time);
+    if (elim_inproc_vars > 0)
+        printf("eliminated variables  : %-12"PRIu64"   (%g s)\n", elim_inproc_vars, elim_inproc_time);
+    printf("garbage collections   : %-12"PRIu64"   (%"PRIu64" of learnts only, %g s)\n", gcs, learnt_gcs, gc_time);
+    if (compactions > 0)
+        printf("compacted variables   : %-12"PRIu64"   (%"PRIu64" renumberings, %d left)\n", compacted_vars, compactions, nVars());
+    if (mem_budget > 0)
+        printf("memory sheds          : %-12"PRIu64"   (budget %.2f MB)\n", mem_sheds, mem_budget / (1024.0*1024));
+    MemUse use[mem_parts];
+    memory(use);
+    for (int i = 0; i < mem_parts; i++)
+        if (use[i].bytes > 0 || mem_peak[i] > 0)
+            printf("memory %-15s: %-12.2f   (MB; peak %.2f, %.2f unused)\n", mem_part_names[i],
+                   use[i].bytes / (1024.0*1024), (use[i].bytes > mem_peak[i] ? use[i].bytes : mem_peak[i]) / (1024.0*1024),
+                   (use[i].bytes - use[i].used) / (1024.0*1024));
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("CPU time              : %g s\n", cpu_time);
 }
 
 
+void Solver::writeStats(FILE* out) const
+{
+    fprintf(out, "{\n");
+    fprintf(out, "  \"restarts\": %"PRIu64",\n", starts);
+    fprintf(out, "  \"conflicts\": %"PRIu64",\n", conflicts);
+    fprintf(out, "  \"decisions\": %"PRIu64",\n", decisions);
+    fprintf(out, "  \"propagations\": %"PRIu64",\n", propagations);
+    fprintf(out, "  \"original_clauses\": %d,\n", nClauses());
+    fprintf(out, "  \"learnt_clauses\": %d,\n", nLearnts());
+    fprintf(out, "  \"reductions\": %"PRIu64",\n", reduces);
+    fprintf(out, "  \"garbage_collections\": %"PRIu64",\n", gcs);
+    fprintf(out, "  \"learnt_garbage_collections\": %"PRIu64",\n", learnt_gcs);
+    fprintf(out, "  \"gc_time\": %g,\n", gc_time);
+    fprintf(out, "  \"memory_budget\": %"PRIu64",\n", mem_budget);
+    fprintf(out, "  \"memory_sheds\": %"PRIu64",\n", mem_sheds);
+
+    // Memory in bytes; 'peak' is over the samples taken by 'sampleMemory()':
+    MemUse use[mem_parts];
+    memory(use);
+    fprintf(out, "  \"memory\": {\n");
+    for (int i = 0; i < mem_parts; i++){
+        uint64_t peak = use[i].bytes > mem_peak[i] ? use[i].bytes : mem_peak[i];
+        fprintf(out, "    \"%s\": { \"bytes\": %"PRIu64", \"peak\": %"PRIu64", \"unused\": %"PRIu64" }%s\n",
+                mem_part_names[i], use[i].bytes, peak, use[i].bytes - use[i].used, i+1 < mem_parts ? "," : "");
+    }
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"process_peak_mb\": %.2f,\n", memUsedPeak());
+    fprintf(out, "  \"cpu_time\": %g\n", cpuTime());
+    fprintf(out, "}\n");
+}
+
+
+//=================================================================================================
+// Memory accounting:
+
+
+const char* const Solver::mem_part_names[mem_parts] =
+    { "arena", "watches", "clause_lists", "variables", "heaps", "occurrences", "elimclauses", "temporaries" };
+
+
+void Solver::memory(MemUse* use) const
+{
+    for (int i = 0; i < mem_parts; i++)
+        use[i].bytes = use[i].used = 0;
+
+    use[mem_arena].add(ca);
+    use[mem_watches].add(watches);
+    use[mem_watches].add(watches_bin);
+
+    MemUse& lists = use[mem_clause_lists];
+    lists.add(clauses);
+    lists.add(learnts);
+
+    MemUse& vars = use[mem_vars];
+    vars.add(trail);      vars.add(trail_lim);  vars.add(assigns);    vars.add(vardata);
+    vars.add(varprefs);   vars.add(activity);   vars.add(lrb_data);   vars.add(equiv);
+    vars.add(equiv_vars); vars.add(hbr_data);   vars.add(vmtf_links); vars.add(vmtf_stamp);
+    vars.add(seen);       vars.add(model);      vars.add(released_vars); vars.add(free_vars);
+    vars.add(ext_lits);   vars.add(ext_vars);
+
+    use[mem_heaps].add(order_heap);
+
+    MemUse& temps = use[mem_temps];
+    temps.add(assumptions);   temps.add(analyze_stack); temps.add(analyze_toclear); temps.add(add_tmp);
+    temps.add(vivify_tmp);    temps.add(hbr_pending);   temps.add(hbr_tmp);         temps.add(lbd_levels);
+    temps.add(reduce_keys);   temps.add(compact_live);  temps.add(reloc_order);     temps.add(compact_saved);
+    temps.add(vmtf_bumped);   temps.add(shrink_marked); temps.add(inproc_tmp);      temps.add(els_index);
+    temps.add(els_low);       temps.add(els_stack);     temps.add(els_frames);      temps.add(els_edges);
+    temps.add(els_comp);      temps.add(subsume_cands); temps.add(subsume_occs);    temps.add(solve_assumps);
+    temps.add(solve_tmp);     temps.add(solve_model);   temps.add(compact_to);
+    for (int i = 0; i < subsume_occs.size(); i++)
+        temps.add(subsume_occs[i]);
+}
+
+
+void Solver::sampleMemory()
+{
+    MemUse use[mem_parts];
+    memory(use);
+    for (int i = 0; i < mem_parts; i++)
+        if (use[i].bytes > mem_peak[i])
+            mem_peak[i] = use[i].bytes;
+}
+
+
+//=================================================================================================
+// Variable compaction:
+
+
+/*_________________________________________________________________________________________________
+|
+|  compactVars : [void]  ->  [bool]
+|  
+|  Description:
+|    Once 'compact_frac' of the variables are fixed at level 0, substituted or removed by a
+|    subclass, renumber the others densely and shrink the per-variable data to them. One fixed
+|    variable is kept to stand for the constants, so that the fixed variables of the user still
+|    map to a literal. Learnt clauses with removed variables are dropped. Returns FALSE if the
+|    problem turned out to be unsatisfiable.
+|  
+|    Pre-conditions:
+|      * Current decision level must be 0.
+|      * Satisfied clauses may be removed ('remove_satisfied'); otherwise nothing is done.
+|________________________________________________________________________________________________@*/
+bool Solver::compactVars()
+{
+    assert(decisionLevel() == 0);
+
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+    if (compact_frac == 0 || !remove_satisfied)
+        return true;
+
+    int removed = 0;
+    for (Var v = 0; v < nVars(); v++)
+        if (value(v) != l_Undef || equiv[v] != lit_Undef || varRemoved(v))
+            removed++;
+    if (removed <= 1 || removed < nVars() * compact_frac)
+        return true;
+
+    // Clauses removed by 'SimpSolver' may still be listed:
+    int i, j;
+    for (int k = 0; k < 2; k++){
+        vec<CRef>& cs = k == 0 ? clauses : learnts;
+        for (i = j = 0; i < cs.size(); i++)
+            if (!isRemoved(cs[i]))
+                cs[j++] = cs[i];
+        cs.shrink(i - j);
+    }
+    removeSatisfied(learnts);
+    removeSatisfied(clauses);
+
+    compact_to.clear();
+    int  n     = 0;
+    bool fixed = false;
+    for (Var v = 0; v < nVars(); v++)
+        if (value(v) != l_Undef ? !fixed : equiv[v] == lit_Undef && !varRemoved(v)){
+            fixed |= value(v) != l_Undef;
+            compact_to.push(n++);
+        }else
+            compact_to.push(var_Undef);
+
+    for (i = j = 0; i < learnts.size(); i++){
+        const Clause& c    = ca[learnts[i]];
+        bool          drop = false;
+        for (int k = 0; k < c.size() && !drop; k++)
+            drop = compact_to[var(c[k])] == var_Undef;
+        if (drop) removeClause(learnts[i]);
+        else      learnts[j++] = learnts[i];
+    }
+    learnts.shrink(i - j);
+
+    if (verbosity >= 2)
+        printf("|  Compacting variables: %12d => %12d                          |\n", nVars(), n);
+    compactions++;
+    compacted_vars += nVars() - n;
+    renumberVars(compact_to, n);
+    checkGarbage();
+    return true;
+}
+
+
+bool Solver::varRemoved(Var) const { return false; }
+
+
+Lit Solver::renumberLit(const vec<Var>& to, Lit fixed, Lit p) const
+{
+    p = equivLit(p);
+    if (value(p) != l_Undef)
+        return fixed ^ (value(p) == l_False);
+    return to[var(p)] == var_Undef ? lit_Undef : mkLit(to[var(p)], sign(p));
+}
+
+
+template<class V>
+static void renumberMap(VMap<V>& map, const vec<Var>& to, int n)
+{
+    VMap<V> moved;
+    if (n > 0) moved.reserve(n-1);
+    for (Var v = 0; v < to.size(); v++)
+        if (to[v] != var_Undef)
+            moved[to[v]] = map[v];
+    moved.moveTo(map);
+}
+
+
+void Solver::renumberVars(const vec<Var>& to, int n)
+{
+    // The literal the kept fixed variable makes true:
+    Lit fixed = lit_Undef;
+    for (Var v = 0; v < nVars(); v++)
+        if (to[v] != var_Undef && value(v) != l_Undef)
+            fixed = mkLit(to[v], value(v) == l_False);
+
+    // The user's view, and the clauses:
+    if (ext_lits.size() == 0)
+        for (Var v = 0; v < nVars(); v++){
+            ext_lits.push(mkLit(v));
+            ext_vars.insert(v, v); }
+    for (int x = 0; x < ext_lits.size(); x++)
+        if (ext_lits[x] != lit_Undef)
+            ext_lits[x] = renumberLit(to, fixed, ext_lits[x]);
+    renumberMap(ext_vars, to, n);
+
+    for (int k = 0; k < 2; k++){
+        vec<CRef>& cs = k == 0 ? clauses : learnts;
+        for (int i = 0; i < cs.size(); i++){
+            Clause& c = ca[cs[i]];
+            for (int j = 0; j < c.size(); j++){
+                assert(to[var(c[j])] != var_Undef);
+                c[j] = mkLit(to[var(c[j])], sign(c[j])); }
+        }
+    }
+
+    // Per-variable data that survives:
+    renumberMap(activity,   to, n);
+    renumberMap(lrb_data,   to, n);
+    renumberMap(varprefs,   to, n);
+    renumberMap(vmtf_stamp, to, n);
+
+    // Per-variable data that starts over (nothing is assigned but the kept fixed variable):
+    assigns .clear(true);
+    vardata .clear(true);
+    equiv   .clear(true);
+    hbr_data.clear(true);
+    seen    .clear(true);
+    for (Var v = 0; v < n; v++){
+        assigns .init(v);
+        vardata .insert(v, mkVarData(CRef_Undef, 0));
+        equiv   .insert(v, lit_Undef);
+        hbr_data.insert(v, mkHbrData(lit_Undef, 0));
+        seen    .insert(v, 0); }
+    equiv_vars   .clear(true);
+    released_vars.clear(true);
+    free_vars    .clear(true);
+    trail        .clear(true);
+    trail        .capacity(n);
+    if (fixed != lit_Undef){
+        assigns.assign(fixed);
+        trail.push_(fixed); }
+    qhead     = trail.size();
+    next_var  = n;
+
+    // The VMTF queue keeps its order:
+    Var last = var_Undef;
+    VMap<VmtfLink> links;
+    if (n > 0) links.reserve(n-1);
+    for (Var v = vmtf_first; v != var_Undef; v = vmtf_links[v].next)
+        if (to[v] != var_Undef){
+            links[to[v]] = mkVmtfLink(last, var_Undef);
+            if (last != var_Undef) links[last].next = to[v];
+            else                   vmtf_first = to[v];
+            last = to[v]; }
+    if (last == var_Undef) vmtf_first = var_Undef;
+    vmtf_last   = last;
+    vmtf_search = last;
+    links.moveTo(vmtf_links);
+
+    dec_vars = 0;
+    for (Var v = 0; v < n; v++)
+        dec_vars += varprefs[v].decision;
+    order_heap.clear(true);
+    rebuildOrderHeap();
+
+    // Watchers, rebuilt as 'attachClause()' would (without counting the clauses again):
+    watches.clear();
+    watches_bin.clear();
+    for (Var v = 0; v < n; v++)
+        for (int s = 0; s < 2; s++){
+            watches    .init(mkLit(v, s));
+            watches_bin.init(mkLit(v, s)); }
+    for (int k = 0; k < 2; k++){
+        const vec<CRef>& cs = k == 0 ? clauses : learnts;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c  = ca[cs[i]];
+            WatchLists&   ws = c.size() == 2 ? watches_bin : watches;
+            ws[~c[0]].push(Watcher(cs[i], c[1]));
+            ws[~c[1]].push(Watcher(cs[i], c[0])); }
+    }
+
+    // Positions that refer to the old numbering:
+    subsume_occs.clear(true);
+    els_index   .clear(true);
+    els_low     .clear(true);
+    probe_head      = 0;
+    vivify_head     = 0;
+    target_assigned = 0;
+    best_assigned   = 0;
+    simpDB_assigns  = nAssigns();
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
+CRef Solver::keptClause() const { return CRef_Undef; }
+
+
 void Solver::relocAll(ClauseAllocator& to)
 {
-    // All watchers:
+    // All watchers. With 'gc_locality', the variables are visited from the most to the least active
+    // (the most recently bumped, with VMTF), so that the clauses watched by the literals propagated
+    // most often end up next to each other:
     //
     watches.cleanAll();
-    for (int v = 0; v < nVars(); v++)
+    watches_bin.cleanAll();
+    if (gc_locality){
+        reloc_order.clear();
+        for (Var v = 0; v < nVars(); v++)
+            reloc_order.push(v);
+        if (branch_heur == branch_vmtf){
+            sort(reloc_order, VmtfStampLt(vmtf_stamp));
+            for (int i = 0, j = reloc_order.size()-1; i < j; i++, j--){
+                Var tmp = reloc_order[i]; reloc_order[i] = reloc_order[j]; reloc_order[j] = tmp; }
+        }else
+            sort(reloc_order, VarOrderLt(activity));
+    }
+    for (int k = 0; k < nVars(); k++){
+        Var v = gc_locality ? reloc_order[k] : k;
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
-            vec<Watcher>& ws = watches[p];
+            WatchList& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            WatchList& wbin = watches_bin[p];
+            for (int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
         }
+    }
+    // Pack the watch lists, dropping the space lost to freed and outgrown blocks:
+    watches.compact();
+    watches_bin.compact();
 
     // All reasons:
     //
@@ -1039,26 +2620,82 @@ void Solver::relocAll(ClauseAllocator& to)
         }
     learnts.shrink(i - j);
 
-    // All original:
+    // All original (left in place when only the learnt clauses are collected):
     //
-    for (i = j = 0; i < clauses.size(); i++)
-        if (!isRemoved(clauses[i])){
-            ca.reloc(clauses[i], to);
-            clauses[j++] = clauses[i];
-        }
-    clauses.shrink(i - j);
+    if (!to.keep_originals){
+        for (i = j = 0; i < clauses.size(); i++)
+            if (!isRemoved(clauses[i])){
+                ca.reloc(clauses[i], to);
+                clauses[j++] = clauses[i];
+            }
+        clauses.shrink(i - j);
+    }
+}
+
+
+// Sliding compaction: the live clauses keep their order in the arena, and each one moves down
+// over the garbage before it. Unlike copying, this needs no second arena, so the peak memory stays
+// at the size of the arena (plus a few words per live clause).
+void Solver::compactForward(bool learnts_only)
+{
+    compact_live.clear();
+    if (!learnts_only){
+        for (int i = 0; i < clauses.size(); i++)
+            if (!isRemoved(clauses[i])) compact_live.push(clauses[i]);
+        if (keptClause() != CRef_Undef)
+            compact_live.push(keptClause()); }
+    for (int i = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i])) compact_live.push(learnts[i]);
+    sort(compact_live);
+
+    CRef top[2] = { ClauseAllocator::start(false), ClauseAllocator::start(true) };
+    compact_saved.clear();
+    for (int i = 0; i < compact_live.size(); i++)
+        ca.forward(compact_live[i], top[ca[compact_live[i]].learnt()], compact_saved);
 }
 
 
-void Solver::garbageCollect()
+void Solver::compactSlide(bool learnts_only)
 {
-    // Initialize the next region to a size corresponding to the estimated utilization degree. This
-    // is not precise but should avoid some unnecessary reallocations for the new region:
-    ClauseAllocator to(ca.size() - ca.wasted()); 
+    CRef top[2] = { ClauseAllocator::start(false), ClauseAllocator::start(true) };
+    int  step   = sizeof(CRef) / sizeof(Lit);
+    for (int i = 0; i < compact_live.size(); i++){
+        bool learnt = ca[compact_live[i]].learnt();
+        top[learnt] = ca.slide(compact_live[i], &compact_saved[i * step]); }
+    if (!learnts_only) ca.truncate(top[0]);
+    ca.truncate(top[1]);
+    compact_live.clear();
+}
+
 
-    relocAll(to);
+void Solver::garbageCollect(bool learnts_only)
+{
+    sampleMemory();
+
+    double start_time = cpuTime();
+    CRef   prev_size  = ca.size();
+
+    // Under memory pressure there may be no room for a second arena:
+    if ((gc_inplace && !gc_locality) || mem_pressure){
+        ca.keep_originals = learnts_only;
+        compactForward(learnts_only);
+        relocAll(ca);
+        compactSlide(learnts_only);
+        ca.keep_originals = false;
+    }else{
+        // Initialize the next regions to sizes corresponding to the estimated utilization degree. This
+        // is not precise but should avoid some unnecessary reallocations for the new regions:
+        ClauseAllocator to(learnts_only ? 0 : ca.size(false) - ca.wasted(false), ca.size(true) - ca.wasted(true));
+
+        to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
+        to.keep_originals     = learnts_only;
+        relocAll(to);
+        to.moveTo(ca);
+    }
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
-    to.moveTo(ca);
+        printf("|  Garbage collection:   %12"PRIu64" bytes => %12"PRIu64" bytes             |\n", 
+               (uint64_t)prev_size*ClauseAllocator::Unit_Size, (uint64_t)ca.size()*ClauseAllocator::Unit_Size);
+    gcs++;
+    if (learnts_only) learnt_gcs++;
+    gc_time += cpuTime() - start_time;
 }
@@ -99,24 +99,36 @@ public:
     int     nAssigns   ()      const;       // The current number of assigned literals.
     int     nClauses   ()      const;       // The current number of original clauses.
     int     nLearnts   ()      const;       // The current number of learnt clauses.
-    int     nVars      ()      const;       // The current number of variables.
+    int     nVars      ()      const;       // The current number of variables (internal ones, after renumbering; see 'compact_frac').
     int     nFreeVars  ()      const;
     void    printStats ()      const;       // Print some current statistics to standard output.
+    void    writeStats (FILE* out) const;   // Write the same statistics as a JSON object.
 
     // Resource contraints:
     //
     void    setConfBudget(int64_t x);
     void    setPropBudget(int64_t x);
+    void    setMemBudget (uint64_t bytes); // Soft limit on the memory of the solver (see 'mem_soft'); 0 means none.
     void    budgetOff();
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
 
     // Memory managment:
     //
-    virtual void garbageCollect();
+    virtual void garbageCollect(bool learnts_only = false); // Compact the clause arena (or only the region of the learnt clauses).
     void    checkGarbage(double gf);
     void    checkGarbage();
 
+    // Memory accounting: the bytes allocated by each part of the solver, and how many of them hold data.
+    enum { mem_arena, mem_watches, mem_clause_lists, mem_vars, mem_heaps, mem_occurs, mem_elim, mem_temps, mem_parts };
+    struct MemUse {
+        uint64_t bytes, used;
+        template<class C> void add(const C& c){ bytes += c.bytes(); used += c.usedBytes(); }
+    };
+    static const char* const mem_part_names[mem_parts];
+    virtual void memory      (MemUse* use) const;  // Fill in 'use[0..mem_parts-1]'.
+    void         sampleMemory();                   // Update 'mem_peak' (done at every reduction and garbage collection).
+
     // Extra results: (read-only member variable)
     //
     vec<lbool> model;             // If problem is satisfiable, this vector contains the model (if any).
@@ -131,12 +143,30 @@ public:
     double    random_var_freq;
     double    random_seed;
     bool      luby_restart;
+    bool      lbd_restart;        // Restart when the fast moving average of learnt clause LBD exceeds the slow one.
+    double    restart_margin;     // ... by this factor.                                                                       (default 1.25)
+    bool      use_stable;         // Alternate between focused and stable search modes.
+    int       mode_interval;      // Number of conflicts of the first focused and stable modes.                                (default 1000)
+    double    mode_inc;           // Mode length increase factor after each stable mode.                                        (default 2)
+    double    focus_decay;        // Variable activity decay factor in focused mode.                                             (default 0.75)
+    int       stable_restart_first; // The base restart interval (Luby) in stable mode.                                      (default 1024)
+    double    block_margin;       // Postpone restarts when the trail exceeds its moving average by this factor (0 = never).  (default 1.4)
     int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep).
+    bool      use_shrink;         // Replace the literals of each lower decision level of a learnt clause by a UIP of that level.
+    bool      use_binmin;         // Remove learnt clause literals implied by the negation of the asserting literal through binaries.
+    bool      use_otfs;           // Strengthen antecedents subsumed by an intermediate resolvent in 'analyze()'.
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
+    int       branch_heur;        // The branching heuristic (0=vsids, 1=vmtf, 2=lrb).                                         (default 0)
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+    bool      gc_inplace;         // Compact the clause arena in place instead of copying it to a new one.
+    bool      gc_locality;        // Copy the clauses watched by the most active variables first (overrides 'gc_inplace').
+    double    compact_frac;       // Renumber the variables densely once this fraction of them is removed (0 = never).      (default 0)
+                                  // Afterwards 'newVar()', 'releaseVar()', 'addClause()', the assumptions, 'model' and
+                                  // 'conflict' keep the numbering of the user; the other methods take internal variables.
     int       min_learnts_lim;    // Minimum number to set the learnts limit to.
+    double    mem_soft;           // Fraction of the memory budget at which learnt clauses are shed.                      (default 0.8)
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -146,18 +176,102 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    // Inprocessing (at level 0, between restarts). The tick budget of each technique is a fraction of
+    // the search propagations since the previous pass:
+    int       inproc_interval;    // Number of conflicts between two inprocessing passes.                                (default 5000)
+    bool      use_probe;          // Probe the roots of the binary implication graph for failed literals.
+    double    probe_effort;       // Tick budget of probing (in propagations).                                            (default 0.05)
+    bool      use_els;            // Substitute the equivalent literals found in the binary implication graph.
+    bool      use_subsume;        // Remove subsumed clauses and strengthen clauses by self-subsuming resolution.
+    double    subsume_effort;     // Tick budget of subsumption (in literals visited).                                    (default 0.5)
+    bool      use_vivify;         // Vivify learnt clauses.
+    double    vivify_effort;      // Tick budget of vivification (in propagations).                                       (default 0.1)
+
+    bool      lbd_reduce;         // Rank local-tier clauses by LBD before activity in 'reduceDB()'.
+    int       core_lbd;           // Learnt clauses with at most this LBD are kept forever.                               (default 2)
+    int       tier2_lbd;          // Learnt clauses with at most this LBD are kept while they take part in conflicts.     (default 6)
+    int       tier2_interval;     // Number of conflicts a tier2 clause may go unused before it is moved to the local tier. (default 10000)
+    bool      use_hbr;            // Add hyper-binary resolvents of the implications found at decision level 1.
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, num_clauses, num_learnts, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t inproc_passes;
+    uint64_t probe_lits, probe_failed, els_vars, subsumed_clauses, subsume_strengthened;
+    uint64_t vivify_lits, vivify_clauses, elim_inproc_vars;
+    double   probe_time, els_time, subsume_time, vivify_time, elim_inproc_time;
+    uint64_t watch_visits, clause_visits;  // Watchers inspected and clauses dereferenced by 'propagate()'.
+    uint64_t hbr_bins, hbr_redundant;      // Hyper-binary resolvents added, and skipped as already implied by binaries.
+    uint64_t learnts_lbd, glue_learnts, lbd_updates; // Sum of the LBDs of learnt clauses, learnt clauses with LBD <= 2, LBDs lowered in 'analyze()'.
+    uint64_t tier_promotions, tier2_demotions;
+    uint64_t reduces, reduce_learnts;      // Calls to 'reduceDB()', and local-tier clauses ranked by them.
+    double   reduce_time;
+    uint64_t blocked_restarts, mode_switches, stable_conflicts;
+    uint64_t shrunk_literals, binmin_literals;   // Literals removed from learnt clauses by 'shrinkLearnt()' and 'binaryMinimize()'.
+    uint64_t otfs_strengthened;
+    uint64_t gcs, learnt_gcs;              // Garbage collections of the clause arena (of its learnt region only), and the time they took.
+    double   gc_time;
+    uint64_t compactions, compacted_vars;  // Renumberings of the variables, and variables removed by them.
+    uint64_t mem_peak[mem_parts];          // Largest number of bytes allocated by each part of the solver, over the samples.
+    uint64_t mem_sheds;                    // Times learnt clauses were shed to stay within the memory budget.
 
 protected:
 
     // Helper structures:
     //
+    // Tiers of the learnt clause database (stored in the clause header):
+    enum { tier_core = 0, tier_2 = 1, tier_local = 2 };
+
+    // Dynamic restarts: smoothing factors, minimum number of conflicts between two restarts, and
+    // number of conflicts before restarts may be blocked:
+    static const double lbd_ema_fast_alpha;
+    static const double lbd_ema_slow_alpha;
+    static const double trail_ema_alpha;
+    enum { restart_min_conflicts = 50, restart_block_start = 10000 };
+
+    // Number of conflicts between two checks of the memory budget:
+    enum { mem_check_interval = 1000 };
+
+    // States of 'seen' during conflict clause minimization. The passes after 'litRedundant()' mark
+    // literals with an extra bit, keeping the state underneath:
+    enum { seen_undef = 0, seen_source = 1, seen_removable = 2, seen_failed = 3, seen_mark = 4 };
+
+    // Branching heuristics:
+    enum { branch_vsids = 0, branch_vmtf = 1, branch_lrb = 2 };
+
+    // Learning-rate branching: initial and final step size of the moving average, and the amount it
+    // shrinks by per conflict:
+    static const double lrb_step_init;
+    static const double lrb_step_min;
+    static const double lrb_step_dec;
+    static const double lrb_decay;
+
     struct VarData { CRef reason; int level; };
     static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
 
+    // Phases and decision flag of a variable, read together when it is unassigned and when it is picked:
+    struct VarPrefs {
+        char  polarity;   // The preferred polarity.
+        char  best_pol;   // Polarity in the largest conflict-free assignment since the last mode switch.
+        lbool target_val; // Value in the largest conflict-free assignment of the current stable mode (as 'value()' gives it).
+        lbool user_pol;   // The users preferred polarity.
+        char  decision;   // Declares if the variable is eligible for selection in the decision heuristic.
+    };
+
+    // Position of a level-1 literal in the binary implication tree rooted at the decision:
+    struct HbrData { Lit dom; int depth; };
+    static inline HbrData mkHbrData(Lit dom, int depth){ HbrData d = {dom, depth}; return d; }
+
+    // Neighbours of a variable in the VMTF decision queue, from least to most recently bumped:
+    struct VmtfLink { Var prev, next; };
+    static inline VmtfLink mkVmtfLink(Var prev, Var next){ VmtfLink l = {prev, next}; return l; }
+
+    // Conflicts at which a variable was last assigned and unassigned, and the number of learnt clauses
+    // it took part in (or was a reason for a literal of) while assigned:
+    struct LrbData { uint64_t assigned, unassigned; uint32_t participated, reasoned; };
+    static inline LrbData mkLrbData(uint64_t a, uint64_t u){ LrbData d = {a, u, 0, 0}; return d; }
+
     struct Watcher {
         CRef cref;
         Lit  blocker;
@@ -173,18 +287,44 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    // Watch lists share one pool of memory (see 'VecPool'):
+    typedef PoolLists<Lit, Watcher, WatcherDeleted, MkIndexLit> WatchLists;
+    typedef PoolVec<Watcher>                                    WatchList;
+
     struct VarOrderLt {
         const IntMap<Var, double>&  activity;
         bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
         VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
     };
 
+    struct VmtfStampLt {
+        const VMap<uint64_t>& stamp;
+        bool operator () (Var x, Var y) const { return stamp[x] < stamp[y]; }
+        VmtfStampLt(const VMap<uint64_t>& s) : stamp(s) { }
+    };
+
+    struct LevelGt {
+        const VMap<VarData>& vardata;
+        bool operator () (Lit x, Lit y) const { return vardata[var(x)].level > vardata[var(y)].level; }
+        LevelGt(const VMap<VarData>& vd) : vardata(vd) { }
+    };
+
     struct ShrinkStackElem {
         uint32_t i;
         Lit      l;
         ShrinkStackElem(uint32_t _i, Lit _l) : i(_i), l(_l){}
     };
 
+    // What 'reduceDB()' ranks a clause by, copied out of the arena so that ranking does not touch
+    // it. Clauses with a higher 'rank' go first, then the less active; binaries have rank 0:
+    struct ReduceKey { uint32_t rank; float act; CRef cr; };
+    static inline ReduceKey mkReduceKey(uint32_t rank, float act, CRef cr){ ReduceKey k = {rank, act, cr}; return k; }
+
+    struct ReduceKeyLt {
+        bool operator()(const ReduceKey& x, const ReduceKey& y) const {
+            return x.rank != y.rank ? x.rank > y.rank : x.act < y.act; }
+    };
+
     // Solver state:
     //
     vec<CRef>           clauses;          // List of problem clauses.
@@ -193,16 +333,29 @@ protected:
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
 
-    VMap<double>        activity;         // A heuristic measurement of the activity of a variable.
-    VMap<lbool>         assigns;          // The current assignments.
-    VMap<char>          polarity;         // The preferred polarity of each variable.
-    VMap<lbool>         user_pol;         // The users preferred polarity of each variable.
-    VMap<char>          decision;         // Declares if a variable is eligible for selection in the decision heuristic.
+    // Per-variable data is grouped by the loops that read it: 'propagate()' needs nothing but 'assigns',
+    // 'analyze()' reads 'vardata' and 'seen' (and bumps 'activity'), and backtracking reads 'varprefs'.
+    // ('seen' is kept apart: the walks down the trail in 'analyze()' find it denser on its own.)
+    //
+    AssignMap           assigns;          // The current assignments.
     VMap<VarData>       vardata;          // Stores reason and level for each variable.
-    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
-                        watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    VMap<VarPrefs>      varprefs;         // Stores phases and decision flag for each variable.
+    VMap<double>        activity;         // A heuristic measurement of the activity of a variable.
+    VMap<LrbData>       lrb_data;         // Learning rate statistics of the current assignment (valid when 'branch_heur' is 'branch_lrb').
+    VMap<Lit>           equiv;            // The literal each variable was substituted by, if any ('lit_Undef' otherwise).
+    vec<Var>            equiv_vars;       // Substituted variables, in the order they were substituted.
+    VMap<HbrData>       hbr_data;         // Dominator and depth of each literal assigned at level 1 (valid when 'use_hbr' is set).
+    WatchLists          watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    WatchLists          watches_bin;      // 'watches_bin[lit]' is the same for binary clauses, with the other literal as blocker.
 
     Heap<Var,VarOrderLt>order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    VMap<VmtfLink>      vmtf_links;       // The VMTF decision queue (used instead of 'order_heap' when 'branch_heur' is 'branch_vmtf').
+    VMap<uint64_t>      vmtf_stamp;       // Time each variable was last moved to the end of the queue.
+    Var                 vmtf_first;       // Least recently bumped variable.
+    Var                 vmtf_last;        // Most recently bumped variable.
+    Var                 vmtf_search;      // All variables bumped after this one are assigned (or not decision variables).
+    uint64_t            vmtf_stamps;      // Last stamp handed out.
+    double              lrb_step;         // Current step size of the learning rate averages.
 
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     double              cla_inc;          // Amount to bump next clause with.
@@ -213,10 +366,31 @@ protected:
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
     Var                 next_var;         // Next variable to be created.
+    uint64_t            next_inproc;      // Number of conflicts at which the next inprocessing pass is due.
+    uint64_t            inproc_props;     // Number of propagations at the end of the last inprocessing pass.
+    int                 probe_head;       // Literal (as 'toInt(Lit)') where the next probing pass starts.
+    int                 vivify_head;      // Position in 'learnts' where the next vivification pass starts.
+    uint64_t            lbd_stamp;        // Stamp of the current 'computeLBD()' call in 'lbd_levels'.
+    int                 local_learnts;    // Number of learnt clauses in the local tier.
+    uint64_t            next_tier2;       // Number of conflicts at which unused tier2 clauses are next moved to the local tier.
+    double              lbd_ema_fast;     // Moving averages of the LBD of learnt clauses, over roughly the last 32 and 16384 conflicts.
+    double              lbd_ema_slow;
+    double              trail_ema;        // Moving average of the trail size at conflicts, over roughly the last 5000 conflicts.
+    bool                stable_mode;      // Currently in stable mode (only with 'use_stable').
+    double              mode_length;      // Number of conflicts of the current pair of modes.
+    uint64_t            next_mode_switch; // Number of conflicts at which the mode is switched next.
+    int                 rephases;         // Number of phase resets so far.
+    int                 target_assigned;  // Size of the conflict-free assignment saved in 'target_val'.
+    int                 best_assigned;    // Size of the conflict-free assignment saved in 'best_pol'.
+    bool                mem_pressure;     // The memory budget was nearly reached: 'max_learnts' stops growing and inprocessing is skipped.
+    uint64_t            mem_shed_limit;   // Memory at which learnt clauses are shed again (under 'mem_pressure').
+    uint64_t            next_mem_check;   // Number of conflicts at which the memory is next checked against 'mem_budget'.
     ClauseAllocator     ca;
 
     vec<Var>            released_vars;
     vec<Var>            free_vars;
+    vec<Lit>            ext_lits;         // After renumbering: the internal literal each variable of the user stands for ('lit_Undef' if eliminated).
+    VMap<Var>           ext_vars;         // After renumbering: the variable of the user each internal variable stands for.
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
     // used, exept 'seen' wich is used in several places.
@@ -225,6 +399,29 @@ protected:
     vec<ShrinkStackElem>analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<Lit>            vivify_tmp;
+    vec<Lit>            hbr_pending;      // Hyper-binary resolvents found by 'propagate()', two literals each.
+    vec<Lit>            hbr_tmp;
+    vec<uint64_t>       lbd_levels;
+    vec<ReduceKey>      reduce_keys;
+    vec<CRef>           compact_live;
+    vec<Var>            reloc_order;
+    vec<Lit>            compact_saved;
+    vec<Var>            vmtf_bumped;
+    vec<Var>            shrink_marked;
+    vec<Lit>            inproc_tmp;
+    vec<int>            els_index;
+    vec<int>            els_low;
+    vec<Lit>            els_stack;
+    vec<Lit>            els_frames;
+    vec<int>            els_edges;
+    vec<Lit>            els_comp;
+    vec<CRef>           subsume_cands;
+    vec<vec<CRef> >     subsume_occs;
+    vec<Lit>            solve_assumps;
+    vec<Lit>            solve_tmp;
+    vec<lbool>          solve_model;
+    vec<Var>            compact_to;
 
     double              max_learnts;
     double              learntsize_adjust_confl;
@@ -234,6 +431,7 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
+    uint64_t            mem_budget;         // 0 means no budget.
     bool                asynch_interrupt;
 
     // Main internal methods:
@@ -244,21 +442,58 @@ protected:
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
-    void     cancelUntil      (int level);                                             // Backtrack until a certain level.
-    void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
+    void     cancelUntil      (int level, bool heur = true);                           // Backtrack until a certain level (saving phases and LRB statistics only if 'heur').
+    void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd); // (bt = backtrack)
     void     analyzeFinal     (Lit p, LSet& out_conflict);                             // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p);                                                 // (helper method for 'analyze()')
+    void     shrinkLearnt     (vec<Lit>& out_learnt);                                  // (helper method for 'analyze()')
+    Lit      levelUIP         (const vec<Lit>& lits, int from, int to);                // (helper method for 'shrinkLearnt()')
+    void     binaryMinimize   (vec<Lit>& out_learnt);                                  // (helper method for 'analyze()')
+    void     otfStrengthen    (CRef cr);                                               // (helper method for 'analyze()')
+    template<class V>
+    int      computeLBD       (const V& c);                                            // Number of distinct decision levels in 'c'.
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
-    void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    void     reduceDB         ();                                                      // Reduce the local tier of learnt clauses.
+    void     switchMode       ();                                                      // Switch between focused and stable mode, and reset phases.
+    void     updatePhases     (int n);                                                 // Save target and best phases from the first 'n' trail literals.
+    void     reduceTier2      ();                                                      // Move the tier2 clauses unused since the last call to the local tier.
+    void     checkMemory      ();                                                      // Shed learnt clauses if the memory nears 'mem_budget'.
+    uint32_t tierOf           (int lbd) const;                                         // The tier a learnt clause with this LBD belongs to.
+    void     setTier          (Clause& c, uint32_t t);                                 // Move a learnt clause to another tier.
+    void     retierShrunk     (Clause& c);                                             // Move a learnt clause shortened in place up to the tier of its LBD.
+    void     updateEMA        (double& ema, double x, double alpha) const;             // Add a sample to a moving average.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    bool     inprocess        ();                                                      // Run the enabled inprocessing techniques at level 0.
+    virtual bool inprocessElim();                                                      // Variable elimination step of 'inprocess()' (see 'SimpSolver').
+    bool     probe            (uint64_t budget);                                       // Failed literal probing on the roots of the binary implication graph.
+    bool     substituteEquivs ();                                                      // Substitute the literals of each strongly connected component of the binary implication graph.
+    bool     elsNode          (Lit p) const;                                           // (helper method for 'substituteEquivs()')
+    bool     subsume          (uint64_t budget);                                       // Forward subsumption and self-subsuming resolution.
+    bool     rewriteClause    (CRef cr, vec<Lit>& lits);                               // Replace the literals of a clause at level 0.
+    Lit      equivLit         (Lit p) const;                                           // The literal 'p' stands for after substitutions.
+    Lit      intern           (Lit p) const;                                           // The internal literal 'p' of the user stands for (after renumbering).
+    Var      internVar        (Var x) const;                                           // The internal variable of 'x' ('var_Undef' if it has none of its own).
+    bool     compactVars      ();                                                      // Renumber the variables if enough of them are removed (see 'compact_frac').
+    virtual bool varRemoved   (Var v) const;                                           // Variables taken out of the problem by a subclass (see 'SimpSolver').
+    virtual void renumberVars (const vec<Var>& to, int n);                             // Move variable 'v' to 'to[v]' ('var_Undef' drops it), leaving 'n' of them.
+    Lit      renumberLit      (const vec<Var>& to, Lit fixed, Lit p) const;            // (helper method for 'renumberVars()')
+    bool     vivify           (uint64_t budget);                                       // Shorten learnt clauses by propagating their negation at level 0.
+    bool     vivifyClause     (CRef cr);                                               // (helper method for 'vivify()')
+    void     hyperBinary      (Lit p, const Clause& c);                                // Place 'p', implied by 'c' at level 1, in the implication tree.
+    Lit      hbrDominator     (Lit p, Lit q) const;                                    // Deepest common dominator of two level-1 literals, or 'lit_Undef'.
+    void     addHyperBinaries ();                                                      // Add the pending hyper-binary resolvents as learnt clauses.
     void     rebuildOrderHeap ();
+    void     vmtfMoveToFront  (Var v);                                                 // Move 'v' to the end of the VMTF queue.
+    void     vmtfBump         ();                                                      // Move the variables of the last conflict to the end of the VMTF queue.
 
     // Maintaining Variable/Clause activity:
     //
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
     void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
     void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
+    void     lrbUpdate        (Var v);                 // Fold the learning rate of the assignment 'v' loses into its activity.
+    void     lrbDecay         (Var v);                 // Apply the decay of the conflicts since 'v' was unassigned to its activity.
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
 
@@ -276,10 +511,15 @@ protected:
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     uint32_t abstractLevel    (Var x) const; // Used to represent an abstraction of sets of decision levels.
     CRef     reason           (Var x) const;
+    int      hbrDepth         (Lit p) const; // Depth of a level-1 literal in the implication tree (0 for the decision).
+    Clause&  reasonClause     (Var x);       // The reason of 'x', with the implied literal at index 0.
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
-    void     relocAll         (ClauseAllocator& to);
+    virtual void relocAll     (ClauseAllocator& to);
+    virtual CRef keptClause   () const;      // A clause in no clause list that garbage collection must keep ('CRef_Undef' if none).
+    void     compactForward   (bool learnts_only);                         // Forward the live clauses for an in-place compaction.
+    void     compactSlide     (bool learnts_only);                         // Move the forwarded clauses down, once all references are redirected.
 
     // Static helpers:
     //
@@ -301,12 +541,56 @@ protected:
 // Implementation of inline methods:
 
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
+
+inline uint32_t Solver::tierOf(int lbd) const { return lbd <= core_lbd ? tier_core : lbd <= tier2_lbd ? tier_2 : tier_local; }
+inline void     Solver::setTier(Clause& c, uint32_t t) {
+    local_learnts += (t == tier_local) - (c.tier() == tier_local);
+    c.tier(t); }
+inline void     Solver::retierShrunk(Clause& c) {
+    if (c.learnt() && tierOf(c.lbd()) < c.tier()){
+        setTier(c, tierOf(c.lbd()));
+        tier_promotions++; } }
+
+// Until there are 1/alpha samples, the plain average is used so that early samples are not biased
+// towards the initial 0:
+inline void Solver::updateEMA(double& ema, double x, double alpha) const {
+    double a = 1.0 / conflicts;
+    ema += (a > alpha ? a : alpha) * (x - ema); }
+
+inline int Solver::hbrDepth(Lit p) const { return reason(var(p)) == CRef_Undef ? 0 : hbr_data[var(p)].depth; }
+
+// 'propagate()' does not touch binary clauses, so their implied literal may be at either index:
+inline Clause& Solver::reasonClause(Var x) {
+    Clause& c = ca[reason(x)];
+    if (c.size() == 2 && var(c[0]) != x){
+        Lit tmp = c[0]; c[0] = c[1]; c[1] = tmp; }
+    return c; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
+inline Lit  Solver::equivLit(Lit p) const {
+    while (equiv[var(p)] != lit_Undef)
+        p = equiv[var(p)] ^ sign(p);
+    return p; }
+
+inline Lit  Solver::intern(Lit p) const {
+    if (ext_lits.size() > 0){
+        Lit q = ext_lits[var(p)];
+        if (q == lit_Undef) return lit_Undef;
+        p = q ^ sign(p); }
+    return equivLit(p); }
+inline Var  Solver::internVar(Var x) const {
+    if (ext_lits.size() == 0) return x;
+    Lit q = ext_lits[x];
+    return q != lit_Undef && ext_vars[var(q)] == x ? var(q) : var_Undef; }
 
 inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
-
-inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
+    if (!varprefs[x].decision) return;
+    if (branch_heur == branch_vmtf){
+        if (vmtf_search == var_Undef || vmtf_stamp[x] > vmtf_stamp[vmtf_search])
+            vmtf_search = x;
+    }else if (!order_heap.inHeap(x))
+        order_heap.insert(x); }
+
+inline void Solver::varDecayActivity() { var_inc *= (1 / (use_stable && !stable_mode ? focus_decay : var_decay)); }
 inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
 inline void Solver::varBumpActivity(Var v, double inc) {
     if ( (activity[v] += inc) > 1e100 ) {
@@ -319,6 +603,16 @@ inline void Solver::varBumpActivity(Var v, double inc) {
     if (order_heap.inHeap(v))
         order_heap.decrease(v); }
 
+inline void Solver::lrbUpdate(Var v) {
+    LrbData& d = lrb_data[v];
+    uint64_t interval = conflicts - d.assigned;
+    d.unassigned = conflicts;
+    if (interval > 0){
+        double rate = (d.participated + d.reasoned) / (double)interval;
+        activity[v] = (1 - lrb_step) * activity[v] + lrb_step * rate;
+        if (order_heap.inHeap(v))
+            order_heap.update(v); } }
+
 inline void Solver::claDecayActivity() { cla_inc *= (1 / clause_decay); }
 inline void Solver::claBumpActivity (Clause& c) {
         if ( (c.activity() += cla_inc) > 1e20 ) {
@@ -329,8 +623,10 @@ inline void Solver::claBumpActivity (Clause& c) {
 
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
-    if (ca.wasted() > ca.size() * gf)
-        garbageCollect(); }
+    if (ca.wasted(false) > ca.size(false) * gf)
+        garbageCollect();
+    else if (ca.wasted(true) > ca.size(true) * gf)
+        garbageCollect(true); }
 
 // NOTE: enqueue does not set the ok flag! (only public methods do)
 inline bool     Solver::enqueue         (Lit p, CRef from)      { return value(p) != l_Undef ? value(p) != l_False : (uncheckedEnqueue(p, from), true); }
@@ -342,13 +638,15 @@ inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
 
 inline bool     Solver::isRemoved       (CRef cr)         const { return ca[cr].mark() == 1; }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const {
+    int i = c.size() == 2 && value(c[0]) != l_True ? 1 : 0;
+    return value(c[i]) == l_True && reason(var(c[i])) != CRef_Undef && ca.lea(reason(var(c[i]))) == &c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
 inline uint32_t Solver::abstractLevel (Var x) const   { return 1 << (level(x) & 31); }
-inline lbool    Solver::value         (Var x) const   { return assigns[x]; }
-inline lbool    Solver::value         (Lit p) const   { return assigns[var(p)] ^ sign(p); }
+inline lbool    Solver::value         (Var x) const   { return assigns.value(x); }
+inline lbool    Solver::value         (Lit p) const   { return assigns.value(p); }
 inline lbool    Solver::modelValue    (Var x) const   { return model[x]; }
 inline lbool    Solver::modelValue    (Lit p) const   { return model[var(p)] ^ sign(p); }
 inline int      Solver::nAssigns      ()      const   { return trail.size(); }
@@ -357,17 +655,18 @@ inline int      Solver::nLearnts      ()      const   { return num_learnts; }
 inline int      Solver::nVars         ()      const   { return next_var; }
 // TODO: nFreeVars() is not quite correct, try to calculate right instead of adapting it like below:
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
-inline void     Solver::setPolarity   (Var v, lbool b){ user_pol[v] = b; }
+inline void     Solver::setPolarity   (Var v, lbool b){ varprefs[v].user_pol = b; }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
-    if      ( b && !decision[v]) dec_vars++;
-    else if (!b &&  decision[v]) dec_vars--;
+    if      ( b && !varprefs[v].decision) dec_vars++;
+    else if (!b &&  varprefs[v].decision) dec_vars--;
 
-    decision[v] = b;
+    varprefs[v].decision = b;
     insertVarOrder(v);
 }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
+inline void     Solver::setMemBudget (uint64_t bytes){ mem_budget = bytes; }
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#include <string.h>
 
 #include "minisat/mtl/IntTypes.h"
 #include "minisat/mtl/Alg.h"
@@ -30,6 +31,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "minisat/mtl/IntMap.h"
 #include "minisat/mtl/Map.h"
 #include "minisat/mtl/Alloc.h"
+#include "minisat/mtl/VecPool.h"
 
 namespace Minisat {
 
@@ -131,6 +133,47 @@ inline lbool toLbool(int   v) { return lbool((uint8_t)v);  }
 #endif
 
 
+//=================================================================================================
+// AssignMap -- a map from variables to their current value, laid out for fast literal lookups:
+//
+// By default the value is stored once per literal, indexed by 'toInt(Lit)', so that 'value(Lit)'
+// is a single byte load without a sign correction. Defining 'MINISAT_PACKED_ASSIGNS' packs the
+// values 2 bits per variable instead, which is 8 times smaller and keeps far more of the map in
+// cache on instances with very many variables, at the price of some bit fiddling per access.
+
+class AssignMap {
+#if defined(MINISAT_PACKED_ASSIGNS)
+    vec<uint32_t> words;   // 16 variables per word, 2 bits per variable holding an 'lbool'.
+
+    static int   word (Var v) { return v >> 4; }
+    static int   shift(Var v) { return (v & 15) << 1; }
+    void         set  (Var v, uint32_t x) { words[word(v)] = (words[word(v)] & ~(3u << shift(v))) | (x << shift(v)); }
+
+ public:
+    void  init    (Var v)       { words.growTo(word(v)+1, 0xAAAAAAAA); set(v, toInt(l_Undef)); }
+    lbool value   (Var v) const { return toLbool((words[word(v)] >> shift(v)) & 3); }
+    lbool value   (Lit p) const { return value(var(p)) ^ sign(p); }
+    void  assign  (Lit p)       { set(var(p), sign(p)); }
+    void  unassign(Var v)       { set(v, toInt(l_Undef)); }
+    void  clear   (bool dealloc = false) { words.clear(dealloc); }
+    uint64_t bytes    () const  { return words.bytes(); }
+    uint64_t usedBytes() const  { return words.usedBytes(); }
+#else
+    vec<lbool>    vals;    // Indexed by 'toInt(Lit)'; the two literals of a variable are adjacent.
+
+ public:
+    void  init    (Var v)       { vals.growTo(2*v+2, l_Undef); vals[2*v] = vals[2*v+1] = l_Undef; }
+    lbool value   (Var v) const { return vals[2*v]; }
+    lbool value   (Lit p) const { return vals[toInt(p)]; }
+    void  assign  (Lit p)       { vals[toInt(p)] = l_True; vals[toInt(~p)] = l_False; }
+    void  unassign(Var v)       { vals[2*v] = vals[2*v+1] = l_Undef; }
+    void  clear   (bool dealloc = false) { vals.clear(dealloc); }
+    uint64_t bytes    () const  { return vals.bytes(); }
+    uint64_t usedBytes() const  { return vals.usedBytes(); }
+#endif
+};
+
+
 //=================================================================================================
 // Clause -- a simple class for representing a clause:
 
@@ -143,8 +186,11 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned size      : 27; }                        header;
-    union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
+        unsigned tier      : 2;
+        unsigned used      : 1;
+        unsigned lbd       : 24;
+        unsigned size      : 32; }                        header;
+    union { Lit lit; float act; uint32_t abs; } data[0];
 
     friend class ClauseAllocator;
 
@@ -154,6 +200,9 @@ class Clause {
         header.learnt    = learnt;
         header.has_extra = use_extra;
         header.reloced   = 0;
+        header.tier      = 0;
+        header.used      = 0;
+        header.lbd       = 0;
         header.size      = ps.size();
 
         for (int i = 0; i < ps.size(); i++) 
@@ -193,7 +242,10 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    // (a learnt clause spans at most one decision level per literal after the asserting one, so
+    //  shortening it clamps its LBD)
+    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i;
+                                               if (header.learnt && header.size > 0 && header.lbd >= header.size) header.lbd = header.size - 1; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -201,9 +253,17 @@ public:
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
+    uint32_t     lbd         ()      const   { return header.lbd; }
+    void         lbd         (uint32_t l)    { header.lbd = l < (1u << 24) ? l : (1u << 24) - 1; }
+    uint32_t     tier        ()      const   { return header.tier; }
+    void         tier        (uint32_t t)    { header.tier = t; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool u)        { header.used = u; }
+
     bool         reloced     ()      const   { return header.reloced; }
-    CRef         relocation  ()      const   { return data[0].rel; }
-    void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
+    // (the relocation takes the place of the first literals, two of them for a wide 'CRef')
+    CRef         relocation  ()      const   { CRef c; memcpy(&c, data, sizeof(CRef)); return c; }
+    void         relocate    (CRef c)        { header.reloced = 1; memcpy(data, &c, sizeof(CRef)); }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -221,33 +281,68 @@ public:
 
 //=================================================================================================
 // ClauseAllocator -- a simple class for allocating memory for clauses:
+//
+// Original and learnt clauses live in separate regions, so that the churn of the learnt clauses
+// neither fragments the original ones nor makes every garbage collection copy them. The highest
+// bit of a reference selects the region, which halves the room of each: with 32-bit references,
+// the original and the learnt clauses may take at most 2^31 words (8 GB) each, where a single
+// arena could take 2^32. Larger clause databases need 64-bit references (MINISAT_WIDE_CREF).
 
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator
 {
-    RegionAllocator<uint32_t> ra;
+    static const CRef learnt_tag = ~(CRef_Undef >> 1);
+
+    RegionAllocator<uint32_t> ra_orig;
+    RegionAllocator<uint32_t> ra_learnt;
+
+    // Dereferencing is on the hot path of propagation, so it indexes a table by the tag instead
+    // of branching. The learnt base is biased by the tag, so that a learnt reference needs no
+    // masking (the arithmetic wraps around modulo the size of 'uintptr_t'):
+    uintptr_t                 bases[2];
+    void updateBases(){
+        bases[0] = ra_orig  .size() ? (uintptr_t)ra_orig  .lea(0) : 0;
+        bases[1] = ra_learnt.size() ? (uintptr_t)ra_learnt.lea(0) - (uintptr_t)learnt_tag * sizeof(uint32_t) : 0; }
 
+    static CRef offset(CRef r) { return r & ~learnt_tag; }
+    RegionAllocator<uint32_t>&       region(CRef r)       { return r & learnt_tag ? ra_learnt : ra_orig; }
+    const RegionAllocator<uint32_t>& region(CRef r) const { return r & learnt_tag ? ra_learnt : ra_orig; }
+
+    // (a clause always has room for its relocation)
     static uint32_t clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+        int words = size + (int)has_extra;
+        if (words < (int)(sizeof(CRef) / sizeof(uint32_t))) words = sizeof(CRef) / sizeof(uint32_t);
+        return (sizeof(Clause) + (sizeof(Lit) * words)) / sizeof(uint32_t); }
+
+    CRef allocIn(bool learnt, uint32_t words){
+        RegionAllocator<uint32_t>& ra = learnt ? ra_learnt : ra_orig;
+        CRef r = ra.alloc(words);
+        if (ra.size() >= learnt_tag - 1) throw OutOfMemoryException();    // (the region is full, see above)
+        updateBases();
+        return learnt ? r | learnt_tag : r; }
 
  public:
     enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
 
     bool extra_clause_field;
+    bool keep_originals;        // Set on the target of a relocation that collects the learnt clauses only.
 
-    ClauseAllocator(uint32_t start_cap) : ra(start_cap), extra_clause_field(false){}
-    ClauseAllocator() : extra_clause_field(false){}
+    ClauseAllocator(CRef orig_cap, CRef learnt_cap) : ra_orig(orig_cap), ra_learnt(learnt_cap), extra_clause_field(false), keep_originals(false){ updateBases(); }
+    ClauseAllocator() : extra_clause_field(false), keep_originals(false){ updateBases(); }
 
+    // NOTE: with 'keep_originals', only the learnt region is moved.
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
-        ra.moveTo(to.ra); }
+        if (!keep_originals) ra_orig.moveTo(to.ra_orig);
+        ra_learnt.moveTo(to.ra_learnt);
+        updateBases(); to.updateBases(); }
 
     CRef alloc(const vec<Lit>& ps, bool learnt = false)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid       = allocIn(learnt, clauseWord32Size(ps.size(), use_extra));
         new (lea(cid)) Clause(ps, use_extra, learnt);
 
         return cid;
@@ -256,35 +351,81 @@ class ClauseAllocator
     CRef alloc(const Clause& from)
     {
         bool use_extra = from.learnt() | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra));
+        CRef cid       = allocIn(from.learnt(), clauseWord32Size(from.size(), use_extra));
         new (lea(cid)) Clause(from, use_extra);
         return cid; }
 
-    uint32_t size      () const      { return ra.size(); }
-    uint32_t wasted    () const      { return ra.wasted(); }
+    CRef     size      () const      { return ra_orig.size()   + ra_learnt.size(); }
+    CRef     wasted    () const      { return ra_orig.wasted() + ra_learnt.wasted(); }
+    CRef     size      (bool learnt) const { return learnt ? ra_learnt.size()   : ra_orig.size(); }
+    CRef     wasted    (bool learnt) const { return learnt ? ra_learnt.wasted() : ra_orig.wasted(); }
+    uint64_t bytes     () const      { return ra_orig.bytes()     + ra_learnt.bytes(); }
+    uint64_t usedBytes () const      { return ra_orig.usedBytes() + ra_learnt.usedBytes(); }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
-    Clause&       operator[](CRef r)         { return (Clause&)ra[r]; }
-    const Clause& operator[](CRef r) const   { return (Clause&)ra[r]; }
-    Clause*       lea       (CRef r)         { return (Clause*)ra.lea(r); }
-    const Clause* lea       (CRef r) const   { return (Clause*)ra.lea(r);; }
-    CRef          ael       (const Clause* t){ return ra.ael((uint32_t*)t); }
+    Clause&       operator[](CRef r)         { assert(offset(r) < region(r).size()); return *(Clause*)(bases[r >> (sizeof(CRef)*8-1)] + (uintptr_t)r * sizeof(uint32_t)); }
+    const Clause& operator[](CRef r) const   { assert(offset(r) < region(r).size()); return *(Clause*)(bases[r >> (sizeof(CRef)*8-1)] + (uintptr_t)r * sizeof(uint32_t)); }
+    Clause*       lea       (CRef r)         { return (Clause*)region(r).lea(offset(r)); }
+    const Clause* lea       (CRef r) const   { return (Clause*)region(r).lea(offset(r)); }
+    CRef          ael       (const Clause* t){
+        const uint32_t* p = (const uint32_t*)t;
+        if (ra_learnt.size() > 0 && p >= ra_learnt.lea(0) && p <= ra_learnt.lea(ra_learnt.size()-1))
+            return ra_learnt.ael(p) | learnt_tag;
+        return ra_orig.ael(p); }
 
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        ra.free(clauseWord32Size(c.size(), c.has_extra()));
+        region(cid).free(clauseWord32Size(c.size(), c.has_extra()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
     {
+        if (to.keep_originals && !(cr & learnt_tag)) return;
+
         Clause& c = operator[](cr);
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
+        assert(&to != this);    // (compacting in place, every live clause is forwarded beforehand)
         cr = to.alloc(c);
         c.relocate(cr);
     }
+
+    // Sliding compaction in place: the live clauses of a region are forwarded in address order to
+    // 'top' (starting at 'start()'), which is advanced past each of them, keeping the literals that
+    // the relocation overwrites in 'saved'. Once every reference is redirected with
+    // 'reloc(cr, *this)', they are moved down with 'slide()', in the same order (each returns the
+    // end of the moved clause), and the region is cut there with 'truncate()'.
+    static CRef start(bool learnt){ return learnt ? learnt_tag : 0; }
+
+    void forward(CRef cr, CRef& top, vec<Lit>& saved)
+    {
+        Clause& c = operator[](cr);
+        assert(!c.reloced() && top <= cr && (top & learnt_tag) == (cr & learnt_tag));
+        for (int i = 0; i < (int)(sizeof(CRef) / sizeof(Lit)); i++)
+            saved.push(c.data[i].lit);
+        c.relocate(top);
+        top += clauseWord32Size(c.size(), c.has_extra() && (c.learnt() || extra_clause_field));
+    }
+
+    CRef slide(CRef cr, const Lit* saved)
+    {
+        Clause& c  = operator[](cr);
+        CRef    to = c.relocation();
+        for (int i = 0; i < (int)(sizeof(CRef) / sizeof(Lit)); i++)
+            c.data[i].lit = saved[i];
+        c.header.reloced = 0;
+
+        // NOTE: like 'alloc(const Clause&)', this drops the extra field when it is no longer used.
+        bool     use_extra = c.has_extra() && (c.learnt() || extra_clause_field);
+        uint32_t words     = clauseWord32Size(c.size(), use_extra);
+        memmove(lea(to), lea(cr), sizeof(uint32_t) * words);
+        operator[](to).header.has_extra = use_extra;
+        return to + words;
+    }
+
+    void truncate(CRef top){ region(top).truncate(offset(top)); }
 };
 
 //=================================================================================================
@@ -348,6 +489,9 @@ class OccLists
         }
     }
 
+    uint64_t bytes    () const;
+    uint64_t usedBytes() const;
+
     void  clear(bool free = true){
         occs   .clear(free);
         dirty  .clear(free);
@@ -367,6 +511,28 @@ void OccLists<K,Vec,Deleted,MkIndex>::cleanAll()
 }
 
 
+template<class K, class Vec, class Deleted, class MkIndex>
+uint64_t OccLists<K,Vec,Deleted,MkIndex>::bytes() const
+{
+    uint64_t b = occs.bytes() + dirty.bytes() + dirties.bytes();
+    if (occs.size() == 0) return b;    // (no storage to point into, e.g. after 'clear(true)')
+    for (const Vec* v = occs.begin(); v != occs.end(); v++)
+        b += v->bytes();
+    return b;
+}
+
+
+template<class K, class Vec, class Deleted, class MkIndex>
+uint64_t OccLists<K,Vec,Deleted,MkIndex>::usedBytes() const
+{
+    uint64_t b = occs.usedBytes() + dirty.usedBytes() + dirties.usedBytes();
+    if (occs.size() == 0) return b;
+    for (const Vec* v = occs.begin(); v != occs.end(); v++)
+        b += v->usedBytes();
+    return b;
+}
+
+
 template<class K, class Vec, class Deleted, class MkIndex>
 void OccLists<K,Vec,Deleted,MkIndex>::clean(const K& idx)
 {
@@ -380,6 +546,90 @@ void OccLists<K,Vec,Deleted,MkIndex>::clean(const K& idx)
 }
 
 
+//=================================================================================================
+// PoolLists -- 'OccLists' with all lists stored in one 'VecPool':
+
+template<class K, class T, class Deleted, class MkIndex = MkIndexDefault<K> >
+class PoolLists
+{
+    VecPool<T>                      pool;
+    IntMap<K, PoolVec<T>, MkIndex>  occs;
+    IntMap<K, char, MkIndex>        dirty;
+    vec<K>                          dirties;
+    Deleted                         deleted;
+
+ public:
+    PoolLists(const Deleted& d, MkIndex _index = MkIndex()) :
+        occs(_index),
+        dirty(_index),
+        deleted(d){}
+   ~PoolLists(){ clear(); }
+
+    void         init      (const K& idx){ occs.reserve(idx); occs[idx].clear(true); occs[idx] = PoolVec<T>(pool); dirty.reserve(idx, 0); }
+    PoolVec<T>&  operator[](const K& idx){ return occs[idx]; }
+    PoolVec<T>&  lookup    (const K& idx){ if (dirty[idx]) clean(idx); return occs[idx]; }
+
+    void  cleanAll  ();
+    void  clean     (const K& idx);
+    void  smudge    (const K& idx){
+        if (dirty[idx] == 0){
+            dirty[idx] = 1;
+            dirties.push(idx);
+        }
+    }
+
+    // Moves the lists into tightly packed blocks (invalidates pointers into them):
+    void  compact   (){ if (occs.size() > 0) pool.compact(occs.begin(), occs.end()); }
+
+    uint64_t bytes    () const { return pool.bytes() + occs.bytes() + dirty.bytes() + dirties.bytes(); }
+    uint64_t usedBytes() const;
+
+    void  clear(bool free = true){
+        if (occs.size() > 0)
+            for (PoolVec<T>* v = occs.begin(); v != occs.end(); v++)
+                v->clear(true);
+        pool   .clear();
+        occs   .clear(free);
+        dirty  .clear(free);
+        dirties.clear(free);
+    }
+};
+
+
+template<class K, class T, class Deleted, class MkIndex>
+void PoolLists<K,T,Deleted,MkIndex>::cleanAll()
+{
+    for (int i = 0; i < dirties.size(); i++)
+        if (dirty[dirties[i]])
+            clean(dirties[i]);
+    dirties.clear();
+}
+
+
+template<class K, class T, class Deleted, class MkIndex>
+uint64_t PoolLists<K,T,Deleted,MkIndex>::usedBytes() const
+{
+    uint64_t b = occs.usedBytes() + dirty.usedBytes() + dirties.usedBytes();
+    if (occs.size() == 0) return b;
+    for (const PoolVec<T>* v = occs.begin(); v != occs.end(); v++)
+        b += v->usedBytes();
+    return b;
+}
+
+
+template<class K, class T, class Deleted, class MkIndex>
+void PoolLists<K,T,Deleted,MkIndex>::clean(const K& idx)
+{
+    PoolVec<T>& vec = occs[idx];
+    int         i, j;
+    for (i = j = 0; i < vec.size(); i++)
+        if (!deleted(vec[i]))
+            vec[j++] = vec[i];
+    vec.shrink(i - j);
+    dirty[idx] = 0;
+}
+
+
 //=================================================================================================
 // CMap -- a class for mapping clauses to values:
 
@@ -29,35 +29,46 @@ namespace Minisat {
 //=================================================================================================
 // Simple Region-based memory allocator:
 
+// References into a region are indices, so a region holds at most 2^32-1 units. Defining
+// MINISAT_WIDE_CREF makes them 64 bits wide instead, at the price of larger references:
+#if defined(MINISAT_WIDE_CREF)
+typedef uint64_t RegionRef;
+#else
+typedef uint32_t RegionRef;
+#endif
+
 template<class T>
 class RegionAllocator
 {
     T*        memory;
-    uint32_t  sz;
-    uint32_t  cap;
-    uint32_t  wasted_;
+    RegionRef sz;
+    RegionRef cap;
+    RegionRef wasted_;
 
-    void capacity(uint32_t min_cap);
+    void capacity(RegionRef min_cap);
 
  public:
     // TODO: make this a class for better type-checking?
-    typedef uint32_t Ref;
-    enum { Ref_Undef = UINT32_MAX };
+    typedef RegionRef Ref;
+    static const Ref Ref_Undef = ~(Ref)0;
     enum { Unit_Size = sizeof(T) };
 
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
+    explicit RegionAllocator(Ref start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
     ~RegionAllocator()
     {
         if (memory != NULL)
-            ::free(memory);
+            xfree_sized(memory, sizeof(T)*cap);
     }
 
 
-    uint32_t size      () const      { return sz; }
-    uint32_t wasted    () const      { return wasted_; }
+    Ref      size      () const      { return sz; }
+    Ref      wasted    () const      { return wasted_; }
+    uint64_t bytes     () const      { return (uint64_t)cap * sizeof(T); }
+    uint64_t usedBytes () const      { return (uint64_t)(sz - wasted_) * sizeof(T); }
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
+    void     truncate  (Ref size)    { assert(size <= sz); sz = size; wasted_ = 0; }  // (after compacting in place)
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     T&       operator[](Ref r)       { assert(r < sz); return memory[r]; }
@@ -69,7 +80,7 @@ class RegionAllocator
         return  (Ref)(t - &memory[0]); }
 
     void     moveTo(RegionAllocator& to) {
-        if (to.memory != NULL) ::free(to.memory);
+        if (to.memory != NULL) xfree_sized(to.memory, sizeof(T)*to.cap);
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
@@ -83,17 +94,17 @@ class RegionAllocator
 };
 
 template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap)
+void RegionAllocator<T>::capacity(Ref min_cap)
 {
     if (cap >= min_cap) return;
 
-    uint32_t prev_cap = cap;
+    Ref prev_cap = cap;
     while (cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
         // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
         // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        Ref delta = ((cap >> 1) + (cap >> 3) + 2) & ~(Ref)1;
         cap += delta;
 
         if (cap <= prev_cap)
@@ -102,7 +113,7 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
     // printf(" .. (%p) cap = %u\n", this, cap);
 
     assert(cap > 0);
-    memory = (T*)xrealloc(memory, sizeof(T)*cap);
+    memory = (T*)xrealloc_sized(memory, sizeof(T)*prev_cap, sizeof(T)*cap);
 }
 
 
@@ -114,7 +125,7 @@ RegionAllocator<T>::alloc(int size)
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    Ref prev_sz = sz;
     sz += size;
     
     // Handle overflow:
@@ -77,6 +77,8 @@ class Heap {
     Heap(const Comp& c, MkIndex _index = MkIndex()) : indices(_index), lt(c) {}
 
     int  size      ()          const { return heap.size(); }
+    uint64_t bytes    ()       const { return heap.bytes()     + indices.bytes(); }
+    uint64_t usedBytes()       const { return heap.usedBytes() + indices.usedBytes(); }
     bool empty     ()          const { return heap.size() == 0; }
     bool inHeap    (K k)       const { return indices.has(k) && indices[k] >= 0; }
     int  operator[](int index) const { assert(index < heap.size()); return heap[index]; }
@@ -143,8 +145,7 @@ class Heap {
         heap.clear();
 
         for (int i = 0; i < ns.size(); i++){
-            // TODO: this should probably call reserve instead of relying on it being reserved already.
-            assert(indices.has(ns[i]));
+            indices.reserve(ns[i], -1);
             indices[ns[i]] = i;
             heap.push(ns[i]); }
 
@@ -154,10 +155,10 @@ class Heap {
 
     void clear(bool dispose = false) 
     { 
-        // TODO: shouldn't the 'indices' map also be dispose-cleared?
         for (int i = 0; i < heap.size(); i++)
             indices[heap[i]] = -1;
         heap.clear(dispose); 
+        if (dispose) indices.clear(true);
     }
 };
 
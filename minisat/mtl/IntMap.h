@@ -35,6 +35,7 @@ namespace Minisat {
         explicit IntMap(MkIndex _index = MkIndex()) : index(_index){}
         
         bool     has       (K k) const { return index(k) < map.size(); }
+        int      size      ()    const { return map.size(); }
 
         const V& operator[](K k) const { assert(has(k)); return map[index(k)]; }
         V&       operator[](K k)       { assert(has(k)); return map[index(k)]; }
@@ -51,6 +52,9 @@ namespace Minisat {
 
         void     clear  (bool dispose = false) { map.clear(dispose); }
         void     moveTo (IntMap& to)           { map.moveTo(to.map); to.index = index; }
+
+        uint64_t bytes    () const { return map.bytes(); }
+        uint64_t usedBytes() const { return map.usedBytes(); }
         void     copyTo (IntMap& to) const     { map.copyTo(to.map); to.index = index; }
     };
 
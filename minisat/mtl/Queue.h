@@ -40,6 +40,8 @@ public:
 
     void clear (bool dealloc = false) { buf.clear(dealloc); buf.growTo(1); first = end = 0; }
     int  size  () const { return (end >= first) ? end - first : end - first + buf.size(); }
+    uint64_t bytes    () const { return buf.bytes(); }
+    uint64_t usedBytes() const { return (uint64_t)size() * sizeof(T); }
 
     const T& operator [] (int index) const  { assert(index >= 0); assert(index < size()); return buf[(first + index) % buf.size()]; }
     T&       operator [] (int index)        { assert(index >= 0); assert(index < size()); return buf[(first + index) % buf.size()]; }
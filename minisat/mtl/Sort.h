@@ -82,6 +82,41 @@ template <class T> static inline void sort(T* array, int size) {
     sort(array, size, LessThan_default<T>()); }
 
 
+// Reorder 'array' so that position 'k' holds the element it would hold if the array was sorted,
+// with no greater element before it and no smaller one after it. Expected linear time.
+template <class T, class LessThan>
+void select(T* array, int size, int k, LessThan lt)
+{
+    assert(k >= 0 && k < size);
+    while (size > 15){
+        T           pivot = array[size / 2];
+        T           tmp;
+        int         i = -1;
+        int         j = size;
+
+        for(;;){
+            do i++; while(lt(array[i], pivot));
+            do j--; while(lt(pivot, array[j]));
+
+            if (i >= j) break;
+
+            tmp = array[i]; array[i] = array[j]; array[j] = tmp;
+        }
+
+        // Continue in the part that contains position 'k':
+        if (k < i)
+            size = i;
+        else{
+            array += i;
+            size  -= i;
+            k     -= i; }
+    }
+    selectionSort(array, size, lt);
+}
+template <class T> static inline void select(T* array, int size, int k) {
+    select(array, size, k, LessThan_default<T>()); }
+
+
 //=================================================================================================
 // For 'vec's:
 
@@ -90,6 +125,10 @@ template <class T, class LessThan> void sort(vec<T>& v, LessThan lt) {
     sort((T*)v, v.size(), lt); }
 template <class T> void sort(vec<T>& v) {
     sort(v, LessThan_default<T>()); }
+template <class T, class LessThan> void select(vec<T>& v, int k, LessThan lt) {
+    select((T*)v, v.size(), k, lt); }
+template <class T> void select(vec<T>& v, int k) {
+    select(v, k, LessThan_default<T>()); }
 
 
 //=================================================================================================
@@ -88,6 +88,10 @@ public:
     const T& operator [] (Size index) const { return data[index]; }
     T&       operator [] (Size index)       { return data[index]; }
 
+    // Memory accounting, in bytes (memory owned by the elements is not included):
+    uint64_t bytes    (void) const     { return (uint64_t)cap * sizeof(T); }
+    uint64_t usedBytes(void) const     { return (uint64_t)sz  * sizeof(T); }
+
     // Duplicatation (preferred instead):
     void copyTo(vec<T>& copy) const { copy.clear(); copy.growTo(sz); for (Size i = 0; i < sz; i++) copy[i] = data[i]; }
     void moveTo(vec<T>& dest) { dest.clear(true); dest.data = data; dest.sz = sz; dest.cap = cap; data = NULL; sz = 0; cap = 0; }
@@ -99,9 +103,10 @@ void vec<T,_Size>::capacity(Size min_cap) {
     if (cap >= min_cap) return;
     Size add = max((min_cap - cap + 1) & ~1, ((cap >> 1) + 2) & ~1);   // NOTE: grow by approximately 3/2
     const Size size_max = std::numeric_limits<Size>::max();
-    if ( ((size_max <= std::numeric_limits<int>::max()) && (add > size_max - cap))
-    ||   (((data = (T*)::realloc(data, (cap += add) * sizeof(T))) == NULL) && errno == ENOMEM) )
+    if ((size_max <= std::numeric_limits<int>::max()) && (add > size_max - cap))
         throw OutOfMemoryException();
+    data = (T*)xrealloc_sized(data, cap * sizeof(T), (cap + add) * sizeof(T));
+    cap += add;
  }
 
 
@@ -126,7 +131,7 @@ void vec<T,_Size>::clear(bool dealloc) {
     if (data != NULL){
         for (Size i = 0; i < sz; i++) data[i].~T();
         sz = 0;
-        if (dealloc) free(data), data = NULL, cap = 0; } }
+        if (dealloc) xfree_sized(data, cap * sizeof(T)), data = NULL, cap = 0; } }
 
 //=================================================================================================
 }
@@ -0,0 +1,267 @@
+/***************************************************************************************[VecPool.h]
+Copyright (c) 2008-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_VecPool_h
+#define Minisat_VecPool_h
+
+#include <assert.h>
+#include <string.h>
+
+#include "minisat/mtl/IntTypes.h"
+#include "minisat/mtl/XAlloc.h"
+#include "minisat/mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// VecPool -- storage for many small resizable arrays:
+//
+// Arrays get blocks of a power-of-two capacity, carved out of large chunks. Freed blocks are kept
+// on one free list per capacity, and the last block of the current chunk grows in place. Chunks
+// never move, so growing one array leaves pointers into the others valid. Arrays that outgrow
+// the largest block capacity are allocated separately.
+//
+// NOTE! Like 'vec', only for datatypes that can be re-located in memory (with memcpy).
+
+template<class T> class PoolVec;
+
+template<class T>
+class VecPool {
+    enum { max_class = 12, chunk_size = 1 << 16 };
+
+    vec<T*>   chunks;
+    T*        top;                      // Unused space at the end of the current chunk.
+    T*        end;
+    T*        free_lists[max_class+1];  // 'free_lists[k]' links the free blocks of capacity 2^k.
+    uint64_t  chunk_bytes;
+    uint64_t  large_bytes;
+
+    static int   sizeClass(uint32_t cap){ int k = 1; while ((1u << k) < cap) k++; return k; }
+    static T*&   next     (T* block)    { return *(T**)block; }
+    bool         atTop    (T* block, uint32_t cap) const { return block + cap == top && top != chunks.last(); }
+
+    T*    alloc (uint32_t cap);
+    void  free  (T* block, uint32_t cap);
+
+    // Don't allow copying (error prone):
+    VecPool&  operator=(VecPool& other);
+              VecPool  (VecPool& other);
+
+public:
+    enum { max_block = 1 << max_class };
+
+    VecPool() : top(NULL), end(NULL), chunk_bytes(0), large_bytes(0) {
+        assert(2 * sizeof(T) >= sizeof(T*));
+        for (int k = 0; k <= max_class; k++) free_lists[k] = NULL; }
+   ~VecPool() { clear(); }
+
+    // Returns a block of capacity 'new_cap' (a power of two) holding the first 'sz' elements of
+    // 'block', which had capacity 'cap' (0 for none) and is given up:
+    T*    regrow(T* block, uint32_t sz, uint32_t cap, uint32_t new_cap);
+    void  release(T* block, uint32_t cap) { if (cap > 0) free(block, cap); }
+
+    // Copies the arrays into tight blocks of fresh chunks and frees the old ones:
+    void  compact(PoolVec<T>* first, PoolVec<T>* last);
+
+    uint64_t bytes() const { return chunk_bytes + large_bytes; }     // (the arrays tell how much of it they use)
+
+    void  clear   ();
+    void  moveTo  (VecPool& to);
+};
+
+
+//=================================================================================================
+// PoolVec -- a resizable array stored in a 'VecPool':
+//
+// A handle only: the memory belongs to the pool, and copies of a handle share it.
+
+template<class T>
+class PoolVec {
+    VecPool<T>* pool;
+    T*          data;
+    uint32_t    sz;
+    uint32_t    cap;
+
+    void grow(uint32_t min_cap){
+        uint32_t new_cap = cap == 0 ? 2 : cap;
+        while (new_cap < min_cap) new_cap *= 2;
+        if (new_cap == cap) new_cap *= 2;
+        data = pool->regrow(data, sz, cap, new_cap);
+        cap  = new_cap; }
+
+    friend class VecPool<T>;
+
+public:
+    PoolVec()              : pool(NULL), data(NULL), sz(0), cap(0) {}
+    explicit PoolVec(VecPool<T>& p) : pool(&p), data(NULL), sz(0), cap(0) {}
+
+    // Pointer to first element:
+    operator T*       (void)           { return data; }
+
+    // Size operations:
+    int      size     (void) const     { return sz; }
+    int      capacity (void) const     { return cap; }
+    uint64_t usedBytes(void) const     { return (uint64_t)sz * sizeof(T); }
+    void     shrink   (int nelems)     { assert(nelems <= (int)sz); sz -= nelems; }
+    void     shrink_  (int nelems)     { sz -= nelems; }
+    void     pop      (void)           { assert(sz > 0); sz--; }
+    void     clear    (bool dealloc = false){
+        sz = 0;
+        if (dealloc && cap > 0){ pool->release(data, cap); data = NULL; cap = 0; } }
+
+    // Stack interface:
+    void     push     (const T& elem)  { if (sz == cap) grow(sz + 1); data[sz++] = elem; }
+    const T& last     (void) const     { return data[sz-1]; }
+    T&       last     (void)           { return data[sz-1]; }
+
+    // Vector interface:
+    const T& operator [] (int index) const { return data[index]; }
+    T&       operator [] (int index)       { return data[index]; }
+};
+
+
+//=================================================================================================
+// Implementation of template methods:
+
+
+template<class T>
+T* VecPool<T>::alloc(uint32_t cap)
+{
+    if (cap > max_block){
+        large_bytes += (uint64_t)cap * sizeof(T);
+        return (T*)xrealloc_sized(NULL, 0, (size_t)cap * sizeof(T)); }
+
+    int k = sizeClass(cap);
+    if (free_lists[k] != NULL){
+        T* block = free_lists[k];
+        free_lists[k] = next(block);
+        return block; }
+
+    if (top + cap > end){
+        // The remainder of the current chunk is lost until the next 'compact()':
+        top = (T*)xrealloc_sized(NULL, 0, chunk_size * sizeof(T));
+        end = top + chunk_size;
+        chunks.push(top);
+        chunk_bytes += chunk_size * sizeof(T); }
+
+    T* block = top;
+    top += cap;
+    return block;
+}
+
+
+template<class T>
+void VecPool<T>::free(T* block, uint32_t cap)
+{
+    if (cap > max_block){
+        large_bytes -= (uint64_t)cap * sizeof(T);
+        xfree_sized(block, (size_t)cap * sizeof(T));
+    }else if (atTop(block, cap))
+        top = block;
+    else{
+        int k = sizeClass(cap);
+        next(block)   = free_lists[k];
+        free_lists[k] = block; }
+}
+
+
+template<class T>
+T* VecPool<T>::regrow(T* block, uint32_t sz, uint32_t cap, uint32_t new_cap)
+{
+    assert(sz <= cap && cap < new_cap);
+    if (cap > max_block){
+        large_bytes += (uint64_t)(new_cap - cap) * sizeof(T);
+        return (T*)xrealloc_sized(block, (size_t)cap * sizeof(T), (size_t)new_cap * sizeof(T)); }
+
+    // The last block of the current chunk grows in place:
+    if (cap > 0 && atTop(block, cap) && new_cap <= max_block && block + new_cap <= end){
+        top = block + new_cap;
+        return block; }
+
+    T* fresh = alloc(new_cap);
+    if (sz > 0) memcpy(fresh, block, sz * sizeof(T));
+    if (cap > 0) free(block, cap);
+    return fresh;
+}
+
+
+template<class T>
+void VecPool<T>::compact(PoolVec<T>* first, PoolVec<T>* last)
+{
+    VecPool<T> to;
+    for (PoolVec<T>* v = first; v != last; v++){
+        if (v->cap == 0) continue;
+        assert(v->pool == this);
+        if (v->sz == 0){
+            free(v->data, v->cap);
+            v->data = NULL;
+            v->cap  = 0;
+            continue; }
+
+        uint32_t new_cap = 2;
+        while (new_cap < v->sz) new_cap *= 2;
+        if (v->cap > max_block && new_cap > max_block){
+            // Large blocks stay where they are:
+            to.large_bytes += (uint64_t)v->cap * sizeof(T);
+            large_bytes    -= (uint64_t)v->cap * sizeof(T);
+        }else{
+            T* block = to.alloc(new_cap);
+            memcpy(block, v->data, v->sz * sizeof(T));
+            if (v->cap > max_block) free(v->data, v->cap);
+            v->data = block;
+            v->cap  = new_cap; }
+        v->pool = this;
+    }
+    to.moveTo(*this);
+}
+
+
+template<class T>
+void VecPool<T>::clear()
+{
+    // NOTE: large blocks are owned by their arrays, and must have been released before.
+    for (int i = 0; i < chunks.size(); i++)
+        xfree_sized(chunks[i], chunk_size * sizeof(T));
+    chunks.clear(true);
+    top = end = NULL;
+    for (int k = 0; k <= max_class; k++) free_lists[k] = NULL;
+    chunk_bytes = 0;
+}
+
+
+template<class T>
+void VecPool<T>::moveTo(VecPool& to)
+{
+    to.clear();
+    chunks.moveTo(to.chunks);
+    to.top         = top;
+    to.end         = end;
+    to.chunk_bytes = chunk_bytes;
+    to.large_bytes += large_bytes;
+    for (int k = 0; k <= max_class; k++){
+        to.free_lists[k] = free_lists[k];
+        free_lists[k]    = NULL; }
+    top = end = NULL;
+    chunk_bytes = large_bytes = 0;
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -23,6 +23,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(MINISAT_MMAP_REGIONS) && defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace Minisat {
 
@@ -39,6 +44,82 @@ static inline void* xrealloc(void *ptr, size_t size)
         return mem;
 }
 
+
+//=================================================================================================
+// Sized blocks, for arrays that may grow large (the clause arena and 'vec'). The caller passes the
+// current size of the block along with it.
+//
+// With MINISAT_MMAP_REGIONS (Linux only), blocks of at least 'xlarge_min' bytes are mapped directly,
+// in whole huge pages, and marked for transparent huge pages. Their pages are only committed when
+// first touched, and they grow with 'mremap()', which extends or moves the page mappings instead of
+// copying the contents. Smaller blocks come from malloc as before.
+
+#if defined(MINISAT_MMAP_REGIONS) && defined(__linux__)
+
+static const size_t xlarge_min = 2 * 1024 * 1024;    // (the size of a huge page on x86-64)
+
+// Mapped blocks are whole huge pages, aligned on them:
+static inline size_t xlarge_len(size_t size) { return (size + xlarge_min - 1) & ~(xlarge_min - 1); }
+
+static inline void* xmap_aligned(size_t len)
+{
+    char* mem = (char*)mmap(NULL, len + xlarge_min, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        throw OutOfMemoryException();
+    size_t head = (xlarge_min - (size_t)mem % xlarge_min) % xlarge_min;
+    if (head > 0) munmap(mem, head);
+    munmap(mem + head + len, xlarge_min - head);
+#if defined(MADV_HUGEPAGE)
+    madvise(mem + head, len, MADV_HUGEPAGE);
+#endif
+    return mem + head;
+}
+
+static inline void* xrealloc_sized(void* ptr, size_t old_size, size_t size)
+{
+    bool was_large = ptr != NULL && old_size >= xlarge_min;
+    if (size < xlarge_min && !was_large)
+        return xrealloc(ptr, size);
+
+    if (size < xlarge_min){
+        // Shrinking below the limit, back to malloc:
+        void* mem = xrealloc(NULL, size);
+        memcpy(mem, ptr, size);
+        munmap(ptr, xlarge_len(old_size));
+        return mem; }
+
+    size_t len = xlarge_len(size);
+    if (!was_large){
+        void* mem = xmap_aligned(len);
+        if (ptr != NULL){
+            memcpy(mem, ptr, old_size);
+            free(ptr); }
+        return mem; }
+
+    // Grow the mapping where it is if the next pages are free, or move it to a new aligned range:
+    size_t old_len = xlarge_len(old_size);
+    if (len == old_len || mremap(ptr, old_len, len, 0) != MAP_FAILED)
+        return ptr;
+    void* mem = xmap_aligned(len);
+    if (mremap(ptr, old_len, len, MREMAP_MAYMOVE | MREMAP_FIXED, mem) == MAP_FAILED)
+        throw OutOfMemoryException();
+    return mem;
+}
+
+static inline void xfree_sized(void* ptr, size_t size)
+{
+    if (ptr == NULL) return;
+    if (size >= xlarge_min) munmap(ptr, xlarge_len(size));
+    else                    free(ptr);
+}
+
+#else
+
+static inline void* xrealloc_sized(void* ptr, size_t, size_t size) { return xrealloc(ptr, size); }
+static inline void  xfree_sized   (void* ptr, size_t)              { free(ptr); }
+
+#endif
+
 //=================================================================================================
 }
 
@@ -64,6 +64,7 @@ int main(int argc, char** argv)
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", 0, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
+        StringOption stats  ("MAIN", "stats-file", "Write the statistics (as JSON) to this file, suffixed by the process id if there are several.");
         
         parseOptions(argc, argv, true);
 
@@ -79,7 +80,11 @@ int main(int argc, char** argv)
 
         // Try to set resource limits:
         if (cpu_lim != 0) limitTime(cpu_lim);
-        if (mem_lim != 0) limitMemory(mem_lim);
+        if (mem_lim != 0){
+            // What the process already takes is not available to the solver:
+            double used = memUsed();
+            limitMemory(mem_lim);
+            if (used < mem_lim) S.setMemBudget((uint64_t)((mem_lim - used) * 1024 * 1024)); }
         
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
@@ -147,7 +152,7 @@ int main(int argc, char** argv)
                 if (res != NULL){
                 if (ret == l_True){
                     fprintf(res, "SAT\n");
-                    for (int i = 0; i < S.nVars(); i++)
+                    for (int i = 0; i < S.model.size(); i++)
                         if (S.model[i] != l_Undef)
                             fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                     fprintf(res, " 0\n");
@@ -174,7 +179,7 @@ int main(int argc, char** argv)
                 if (res1 != NULL){
                 if (ret1 == l_True){
                     fprintf(res1, "SAT\n");
-                    for (int i = 0; i < S.nVars(); i++)
+                    for (int i = 0; i < S.model.size(); i++)
                         if (S.model[i] != l_Undef)
                             fprintf(res1, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                     fprintf(res1, " 0\n");
@@ -202,7 +207,7 @@ int main(int argc, char** argv)
                 if (res2 != NULL){
                 if (ret2 == l_True){
                     fprintf(res2, "SAT\n");
-                    for (int i = 0; i < S.nVars(); i++)
+                    for (int i = 0; i < S.model.size(); i++)
                         if (S.model[i] != l_Undef)
                             fprintf(res2, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                     fprintf(res2, " 0\n");
@@ -228,7 +233,7 @@ int main(int argc, char** argv)
                 if (res3 != NULL){
                 if (ret3 == l_True){
                     fprintf(res3, "SAT\n");
-                    for (int i = 0; i < S.nVars(); i++)
+                    for (int i = 0; i < S.model.size(); i++)
                         if (S.model[i] != l_Undef)
                             fprintf(res3, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                     fprintf(res3, " 0\n");
@@ -239,6 +244,17 @@ int main(int argc, char** argv)
                 fclose(res3);
             }
         }
+        if (stats){
+            char name[4096];
+            if (size > 1) snprintf(name, sizeof(name), "%s.%d", (const char*)stats, id);
+            else          snprintf(name, sizeof(name), "%s", (const char*)stats);
+            FILE* out = fopen(name, "wb");
+            if (out == NULL)
+                printf("ERROR! Could not open file: %s\n", name);
+            else{
+                S.writeStats(out);
+                fclose(out); }
+        }
         fflush(stdout);
         MPI_Finalize();
 #ifdef NDEBUG
@@ -75,7 +75,9 @@ SimpSolver::~SimpSolver()
 
 
 Var SimpSolver::newVar(lbool upol, bool dvar) {
-    Var v = Solver::newVar(upol, dvar);
+    Var x = Solver::newVar(upol, dvar);
+    Var v = internVar(x);
+    assert(v != var_Undef);    // (a new variable always gets one of its own)
 
     frozen    .insert(v, (char)false);
     eliminated.insert(v, (char)false);
@@ -87,7 +89,7 @@ Var SimpSolver::newVar(lbool upol, bool dvar) {
         touched   .insert(v, 0);
         elim_heap .insert(v);
     }
-    return v; }
+    return x; }
 
 
 void SimpSolver::releaseVar(Lit l)
@@ -136,9 +138,10 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
         extendModel();
 
     if (do_simp)
-        // Unfreeze the assumptions that were frozen:
+        // Unfreeze the assumptions that were frozen (unless 'eliminate()' renumbered them away):
         for (int i = 0; i < extra_frozen.size(); i++)
-            setFrozen(extra_frozen[i], false);
+            if (internVar(extra_frozen[i]) != var_Undef)
+                setFrozen(extra_frozen[i], false);
 
     return result;
 }
@@ -154,7 +157,8 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
 
     int nclauses = clauses.size();
 
-    if (use_rcheck && implied(ps))
+    // (after renumbering, 'ps' is not in the internal numbering yet; see 'Solver::addClause_()')
+    if (use_rcheck && ext_lits.size() == 0 && implied(ps))
         return true;
 
     if (!Solver::addClause_(ps))
@@ -538,6 +542,8 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -647,6 +653,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         assert(subsumption_queue.size() == 0);
     }
  cleanup:
+    sampleMemory();
 
     // If no more simplification is needed, free all simplification-related data structures:
     if (turn_off_elim){
@@ -662,6 +669,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         max_simp_var          = nVars();
 
         // Force full cleanup (this is safe and desirable since it only happens once):
+        compactVars();
         rebuildOrderHeap();
         garbageCollect();
     }else{
@@ -677,13 +685,50 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 }
 
 
+// Called by 'inprocess()' between restarts. Runs only while the occurrence lists are kept, and all
+// assumptions are frozen:
+bool SimpSolver::inprocessElim()
+{
+    if (!use_simplification || !use_elim)
+        return true;
+    for (int i = 0; i < assumptions.size(); i++)
+        if (!frozen[var(assumptions[i])])
+            return true;
+
+    int elimed = eliminated_vars;
+    bool res   = eliminate(false);
+    elim_inproc_vars += eliminated_vars - elimed;
+    return res;
+}
+
+
+//=================================================================================================
+// Memory accounting:
+
+
+void SimpSolver::memory(MemUse* use) const
+{
+    Solver::memory(use);
+    use[mem_occurs].add(occurs);
+    use[mem_occurs].add(subsumption_queue);
+    use[mem_elim]  .add(elimclauses);
+    use[mem_heaps] .add(elim_heap);
+
+    MemUse& vars = use[mem_vars];
+    vars.add(touched); vars.add(n_occ); vars.add(frozen); vars.add(frozen_vars); vars.add(eliminated);
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
 
 void SimpSolver::relocAll(ClauseAllocator& to)
 {
-    if (!use_simplification) return;
+    Solver::relocAll(to);
+
+    // (the occurrence lists and the subsumption queue only hold original clauses)
+    if (!use_simplification || to.keep_originals) return;
 
     // All occurs lists:
     //
@@ -709,17 +754,36 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 }
 
 
-void SimpSolver::garbageCollect()
+// The temporary clause is in no clause list (and is only used with the occurrence lists):
+CRef SimpSolver::keptClause() const { return use_simplification ? bwdsub_tmpunit : CRef_Undef; }
+
+
+//=================================================================================================
+// Variable compaction:
+
+
+bool SimpSolver::varRemoved(Var v) const { return eliminated[v]; }
+
+
+// Only runs once simplification is turned off: the occurrence lists and the elimination heap are
+// gone then, and the eliminated clauses are in the numbering of the user.
+void SimpSolver::renumberVars(const vec<Var>& to, int n)
 {
-    // Initialize the next region to a size corresponding to the estimated utilization degree. This
-    // is not precise but should avoid some unnecessary reallocations for the new region:
-    ClauseAllocator to(ca.size() - ca.wasted()); 
+    assert(!use_simplification);
+    Solver::renumberVars(to, n);
+
+    VMap<char> moved;
+    if (n > 0) moved.reserve(n-1, 0);
+    for (Var v = 0; v < to.size(); v++)
+        if (to[v] != var_Undef)
+            moved[to[v]] = frozen[v];
+    moved.moveTo(frozen);
+    eliminated.clear(true);
+    if (n > 0) eliminated.reserve(n-1, 0);
 
-    to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
-    relocAll(to);
-    Solver::relocAll(to);
-    if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
-    to.moveTo(ca);
+    int i, j;
+    for (i = j = 0; i < frozen_vars.size(); i++)
+        if (to[frozen_vars[i]] != var_Undef)
+            frozen_vars[j++] = to[frozen_vars[i]];
+    frozen_vars.shrink(i - j);
 }
@@ -72,7 +72,7 @@ class SimpSolver : public Solver {
 
     // Memory managment:
     //
-    virtual void garbageCollect();
+    virtual void memory(MemUse* use) const;
 
 
     // Generate a (possibly simplified) DIMACS file:
@@ -163,11 +163,15 @@ class SimpSolver : public Solver {
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
     void          extendModel              ();
+    bool          inprocessElim            ();
 
     void          removeClause             (CRef cr);
     bool          strengthenClause         (CRef cr, Lit l);
     bool          implied                  (const vec<Lit>& c);
     void          relocAll                 (ClauseAllocator& to);
+    CRef          keptClause               () const;
+    bool          varRemoved               (Var v) const;
+    void          renumberVars             (const vec<Var>& to, int n);
 };
 
 
@@ -175,7 +179,7 @@ class SimpSolver : public Solver {
 // Implementation of inline methods:
 
 
-inline bool SimpSolver::isEliminated (Var v) const { return eliminated[v]; }
+inline bool SimpSolver::isEliminated (Var v) const { return ext_lits.size() > 0 ? ext_lits[v] == lit_Undef : eliminated[v]; }
 inline void SimpSolver::updateElimHeap(Var v) {
     assert(use_simplification);
     // if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
@@ -189,10 +193,15 @@ inline bool SimpSolver::addClause    (Lit p)                 { add_tmp.clear();
 inline bool SimpSolver::addClause    (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
-inline void SimpSolver::setFrozen    (Var v, bool b) { frozen[v] = (char)b; if (use_simplification && !b) { updateElimHeap(v); } }
+// (a variable dropped by renumbering is fixed, substituted or eliminated, and has nothing to freeze)
+inline void SimpSolver::setFrozen    (Var v, bool b) {
+    v = internVar(v);
+    if (v == var_Undef) return;
+    frozen[v] = (char)b; if (use_simplification && !b) { updateElimHeap(v); } }
 
 inline void SimpSolver::freezeVar(Var v){
-    if (!frozen[v]){
+    v = internVar(v);
+    if (v != var_Undef && !frozen[v]){
         frozen[v] = 1;
         frozen_vars.push(v); 
     } }
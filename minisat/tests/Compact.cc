@@ -0,0 +1,83 @@
+/**************************************************************************************[Compact.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include "minisat/simp/SimpSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Variable renumbering ('-compact'): the interface keeps the numbering of the user, including for
+// variables that the renumbering dropped.
+
+
+static int failures = 0;
+
+static void check(bool cond, const char* what)
+{
+    if (!cond){
+        printf("FAILED: %s\n", what);
+        failures++; }
+}
+
+
+int main()
+{
+    SimpSolver S;
+    S.compact_frac = 0.05;
+
+    // A chain x0 -> x1 -> ... -> x39 with x0 fixed, and a free tail y0..y19 where y0 is an
+    // assumption (frozen while simplifying) and the others can be eliminated:
+    const int n_chain = 40, n_tail = 20;
+    vec<Var>  xs, ys;
+    for (int i = 0; i < n_chain; i++) xs.push(S.newVar());
+    for (int i = 0; i < n_tail;  i++) ys.push(S.newVar());
+
+    S.addClause(mkLit(xs[0]));
+    for (int i = 0; i + 1 < n_chain; i++)
+        S.addClause(~mkLit(xs[i]), mkLit(xs[i+1]));
+    for (int i = 0; i + 1 < n_tail; i++)
+        S.addClause(~mkLit(ys[i]), mkLit(ys[i+1]), mkLit(xs[i]));
+
+    vec<Lit> assumps;
+    assumps.push(mkLit(ys[0]));
+    check(S.solve(assumps, true, true), "first solve is satisfiable");
+    check(S.compactions == 1, "the variables were renumbered");
+    check(S.nVars() < n_chain + n_tail, "renumbering dropped variables");
+    check(S.model.size() == n_chain + n_tail, "the model keeps the numbering of the user");
+
+    // Freezing variables without an internal variable of their own is a no-op:
+    for (int i = 0; i < n_chain; i++){
+        S.freezeVar(xs[i]);
+        S.setFrozen(xs[i], true);
+        S.setFrozen(xs[i], false); }
+    for (int i = 1; i < n_tail; i++)
+        S.freezeVar(ys[i]);
+    S.thaw();
+
+    assumps.clear();
+    assumps.push(~mkLit(ys[0]));
+    check(S.solve(assumps, true, true), "second solve is satisfiable");
+    for (int i = 0; i < n_chain; i++)
+        check(S.model[xs[i]] == l_True, "the fixed chain is true in the model");
+    check(S.model[ys[0]] == l_False, "the assumption holds in the model");
+
+    assumps.clear();
+    assumps.push(~mkLit(xs[n_chain-1]));
+    check(!S.solve(assumps), "assuming a fixed variable false is unsatisfiable");
+
+    if (failures == 0) printf("OK\n");
+    return failures == 0 ? 0 : 1;
+}